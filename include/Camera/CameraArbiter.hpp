@@ -0,0 +1,75 @@
+/**
+ * @file CameraArbiter.hpp
+ * @brief Распределение режимов камеры между детекцией, снимками и потоком
+ *
+ * Владелец запрашивает профиль сенсора и держит его до освобождения.
+ * Запрос того же профиля, что уже удерживается, присоединяется к нему без
+ * переключения; запрос другого профиля ждёт, пока все владельцы не
+ * освободят камеру. После последнего освобождения восстанавливается
+ * базовый профиль (режим детекции). Владелец с меньшим номером важнее:
+ * пока он ждёт, запросы остальных не удовлетворяются, а длительный
+ * владелец (поток) должен уступить камеру. Модуль не зависит от драйвера камеры
+ * (std::mutex, std::condition_variable) и может проверяться на хосте.
+ */
+
+#ifndef CAMERA_ARBITER_HPP
+#define CAMERA_ARBITER_HPP
+
+#include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief Владельцы камеры
+ */
+enum CameraOwner
+{
+    OWNER_DETECTOR = 0, // съёмка фото по срабатыванию, наивысший приоритет
+    OWNER_SNAPSHOT,     // снимок для веб-интерфейса
+    OWNER_STREAM,       // видеопоток
+    OWNER_COUNT
+};
+
+/**
+ * @brief Статистика запросов владельца
+ */
+struct CameraOwnerStats
+{
+    uint32_t requests = 0;  // удовлетворённые запросы
+    uint32_t switches = 0;  // запросы, сменившие профиль
+    uint32_t coalesced = 0; // присоединения к уже удерживаемому профилю
+    uint32_t timeouts = 0;  // запросы, не дождавшиеся камеры
+    uint32_t waitMax = 0;   // наибольшее ожидание, мс
+    uint32_t waitTotal = 0; // суммарное ожидание, мс
+};
+
+// Применение профиля сенсора; false - профиль не применён
+typedef bool (*ProfileApplier)(void *context, int profile);
+
+/**
+ * @brief Состояние арбитра
+ */
+struct CameraArbiter
+{
+    int base = 0;     // профиль свободной камеры
+    int active = -1;  // удерживаемый профиль, -1 - камера свободна
+    int holders = 0;
+    int holds[OWNER_COUNT] = {0};
+    int waiting[OWNER_COUNT] = {0}; // запросы, ожидающие камеру
+    CameraOwnerStats stats[OWNER_COUNT];
+    ProfileApplier apply = nullptr;
+    void *context = nullptr;
+    std::mutex lock;
+    std::condition_variable released;
+};
+
+// Прототипы функций
+void cameraArbiterInit(CameraArbiter &arbiter, int base, ProfileApplier apply, void *context);
+bool cameraArbiterAcquire(CameraArbiter &arbiter, CameraOwner owner, int profile, uint32_t timeoutMs,
+                          bool *switched);
+void cameraArbiterRelease(CameraArbiter &arbiter, CameraOwner owner);
+bool cameraArbiterPreempted(CameraArbiter &arbiter, CameraOwner owner);
+void cameraArbiterSetBase(CameraArbiter &arbiter, int base);
+const char *cameraOwnerName(int owner);
+
+#endif // CAMERA_ARBITER_HPP
\ No newline at end of file
@@ -7,6 +7,11 @@
 #define CAMERA_CONTROLLER_HPP
 
 #include <esp_camera.h>
+#include "Camera/FrameRing.hpp"
+#include "Camera/JpegHistory.hpp"
+#include "Camera/FrameAge.hpp"
+#include "Camera/SensorProfile.hpp"
+#include "Camera/CameraArbiter.hpp"
 
 // Определение пинов для AI-Thinker ESP32-CAM
 #define PWDN_GPIO_NUM     32
@@ -26,12 +31,79 @@
 #define HREF_GPIO_NUM     23
 #define PCLK_GPIO_NUM     22
 
+// Задача захвата кадров детекции
+#define CAPTURE_TASK_CORE 0
+#define CAPTURE_TASK_PRIORITY 2
+#define CAPTURE_TASK_STACK 4096
+
+// Качество JPEG кадров истории, сжимаемых из полутонового кадра детекции
+#define HISTORY_JPEG_QUALITY 80
+
+// Предел ожидания камеры, занятой другим владельцем, мс
+#define CAMERA_ACQUIRE_TIMEOUT 3000
+
+// Буферов кадра у драйвера (fb_count), столько кадров может ждать в очереди
+#define CAMERA_FB_COUNT 2
+
+/**
+ * @brief Именованные профили сенсора
+ */
+enum CameraProfileId
+{
+    PROFILE_DETECTION = 0, // QQVGA полутон для анализа
+    PROFILE_PHOTO,         // SVGA JPEG для сохранения
+    PROFILE_STREAM,        // QQVGA JPEG для веб-интерфейса
+    PROFILE_NIGHT,         // детекция с ночной экспозицией
+    PROFILE_COUNT
+};
+
+/**
+ * @brief Время переключения в профиль
+ */
+struct CameraProfileStats
+{
+    uint32_t switches = 0;
+    uint32_t lastUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t totalUs = 0;
+};
+
+// Кэш состояния сенсора и время переключения по профилям
+extern SensorCache sensorCache;
+extern CameraProfileStats profileStats[PROFILE_COUNT];
+
+// Распределение режимов камеры между владельцами
+extern CameraArbiter cameraArbiter;
+
+// Кольцо кадров и история JPEG, заполняемые задачей захвата
+extern FrameRing frameRing;
+extern JpegHistory jpegHistory;
+
+// Возраст кадров в момент решения детекции и отправки веб-клиенту
+extern FrameAgeStats detectionFrameAge;
+extern FrameAgeStats webFrameAge;
+
 // Прототипы функций
 bool setupCamera();
 camera_fb_t* captureFrame();
+camera_fb_t* captureFreshFrame(uint32_t maxAge);
+uint32_t frameCaptureTime(const camera_fb_t *fb);
 camera_fb_t* captureHighResFrame();
+camera_fb_t* captureBestFrame(int count, bool fine);
 void releaseFrame(camera_fb_t* fb);
+CameraProfileId detectionProfile();
 void switchToDetectionMode();
-void switchToPhotoMode();
+bool cameraAcquire(CameraOwner owner, CameraProfileId profile, bool *switched);
+void cameraRelease(CameraOwner owner);
+bool cameraPreempted(CameraOwner owner);
+bool applyCameraProfile(CameraProfileId id);
+const char *cameraProfileName(int id);
+bool startCaptureTask();
+bool setupJpegHistory();
+uint32_t waitForExposure(uint32_t ceiling, int tolerance, bool &converged);
+const FrameSlot *acquireLatestFrame(uint32_t newerThan);
+void releaseLatestFrame(const FrameSlot *frame);
+void cameraLock();
+void cameraUnlock();
 
 #endif // CAMERA_CONTROLLER_HPP
\ No newline at end of file
@@ -0,0 +1,30 @@
+/**
+ * @file ExposureSettle.hpp
+ * @brief Признак установления экспозиции по яркости кадров подряд
+ *
+ * Экспозиция считается установившейся, когда средняя яркость несколько
+ * раз подряд меняется между кадрами не больше чем на допуск.
+ * Модуль не зависит от Arduino, поэтому может собираться и проверяться
+ * на хосте.
+ */
+
+#ifndef EXPOSURE_SETTLE_HPP
+#define EXPOSURE_SETTLE_HPP
+
+// Число подряд идущих изменений яркости в пределах допуска
+#define EXPOSURE_STABLE_STEPS 2
+
+/**
+ * @brief Яркость предыдущего кадра и число стабильных изменений подряд
+ */
+struct ExposureSettle
+{
+    int last = -1; // -1 - кадров ещё не было
+    int stable = 0;
+};
+
+// Прототипы функций
+void exposureSettleReset(ExposureSettle &settle);
+bool exposureSettleUpdate(ExposureSettle &settle, int brightness, int tolerance);
+
+#endif // EXPOSURE_SETTLE_HPP
\ No newline at end of file
@@ -0,0 +1,39 @@
+/**
+ * @file FrameAge.hpp
+ * @brief Гистограмма возраста кадров в момент использования
+ *
+ * Возраст - время от захвата кадра сенсором до решения по нему
+ * (детекция) или до отправки клиенту (веб-интерфейс).
+ * Модуль не зависит от Arduino, поэтому может собираться и проверяться
+ * на хосте.
+ */
+
+#ifndef FRAME_AGE_HPP
+#define FRAME_AGE_HPP
+
+#include <stdint.h>
+
+// Число интервалов гистограммы; границы - frameAgeBounds
+#define FRAME_AGE_BUCKETS 8
+
+// Верхние границы интервалов, мс; последний интервал не ограничен
+extern const uint32_t frameAgeBounds[FRAME_AGE_BUCKETS - 1];
+
+/**
+ * @brief Накопленная статистика возраста кадров
+ */
+struct FrameAgeStats
+{
+    uint32_t buckets[FRAME_AGE_BUCKETS] = {0};
+    uint32_t count = 0;
+    uint32_t stale = 0; // кадры старше допустимого возраста
+    uint32_t maxAge = 0;
+    uint64_t totalAge = 0;
+};
+
+// Прототипы функций
+void frameAgeRecord(FrameAgeStats &stats, uint32_t age, uint32_t maxAllowed);
+void frameAgeReset(FrameAgeStats &stats);
+float frameAgeMean(const FrameAgeStats &stats);
+
+#endif // FRAME_AGE_HPP
\ No newline at end of file
@@ -0,0 +1,62 @@
+/**
+ * @file FrameRing.hpp
+ * @brief Кольцо полутоновых кадров с подсчётом ссылок
+ *
+ * Задача захвата пишет кадры в свободные слоты, потребители (детекция,
+ * веб-интерфейс) берут ссылку на самый свежий кадр и возвращают её после
+ * обработки. Слот с ненулевым числом ссылок не перезаписывается.
+ * Модуль не зависит от Arduino и FreeRTOS (std::mutex), поэтому может
+ * собираться и проверяться на хосте.
+ */
+
+#ifndef FRAME_RING_HPP
+#define FRAME_RING_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+// Число слотов кольца: один пишется, один у детекции, один у веб-интерфейса
+#define FRAME_RING_SLOTS 3
+
+/**
+ * @brief Слот кольца с кадром
+ */
+struct FrameSlot
+{
+    uint8_t *buf = nullptr;
+    size_t capacity = 0;
+    size_t len = 0;
+    int width = 0;
+    int height = 0;
+    uint32_t timestamp = 0; // время захвата, мс
+    uint32_t sequence = 0;  // номер кадра, 0 - слот пуст или пишется
+    uint8_t *jpeg = nullptr; // исходный JPEG кадра в однорежимном конвейере
+    size_t jpegCapacity = 0;
+    size_t jpegLen = 0;
+    int refs = 0;
+    bool writing = false;
+};
+
+/**
+ * @brief Кольцо кадров
+ */
+struct FrameRing
+{
+    FrameSlot slots[FRAME_RING_SLOTS];
+    uint32_t sequence = 0;
+    uint32_t framesWritten = 0;
+    uint32_t framesDropped = 0; // все слоты заняты читателями
+    std::mutex lock;
+};
+
+// Прототипы функций
+bool frameRingInit(FrameRing &ring, size_t capacity);
+void frameRingFree(FrameRing &ring);
+FrameSlot *frameRingBeginWrite(FrameRing &ring);
+uint32_t frameRingCommit(FrameRing &ring, FrameSlot *slot, size_t len, int width, int height, uint32_t timestamp);
+void frameRingAbort(FrameRing &ring, FrameSlot *slot);
+const FrameSlot *frameRingAcquireLatest(FrameRing &ring, uint32_t newerThan);
+void frameRingRelease(FrameRing &ring, const FrameSlot *slot);
+
+#endif // FRAME_RING_HPP
\ No newline at end of file
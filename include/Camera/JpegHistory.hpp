@@ -0,0 +1,61 @@
+/**
+ * @file JpegHistory.hpp
+ * @brief История последних сжатых кадров до срабатывания
+ *
+ * Кадры хранятся в одной кольцевой области памяти (в PSRAM на устройстве)
+ * непрерывными кусками; индекс записей - отдельное кольцо. Вытеснение
+ * старых кадров - только сдвиг индекса, данные не копируются. Объём
+ * области ограничен бюджетом, число кадров - лимитом.
+ * Модуль не зависит от Arduino и FreeRTOS, поэтому может собираться
+ * и проверяться на хосте.
+ */
+
+#ifndef JPEG_HISTORY_HPP
+#define JPEG_HISTORY_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+// Наибольшее число кадров истории
+#define JPEG_HISTORY_MAX_FRAMES 32
+
+/**
+ * @brief Запись истории: положение кадра в области и время захвата
+ */
+struct JpegHistoryEntry
+{
+    size_t offset;
+    size_t len;
+    uint32_t timestamp;
+    uint32_t sequence;
+};
+
+/**
+ * @brief История кадров
+ */
+struct JpegHistory
+{
+    uint8_t *arena = nullptr;
+    size_t capacity = 0;
+    size_t head = 0; // конец самого нового кадра
+    JpegHistoryEntry entries[JPEG_HISTORY_MAX_FRAMES];
+    int first = 0;
+    int count = 0;
+    int limit = 0;
+    bool frozen = false;  // идёт сохранение, новые кадры не принимаются
+    uint32_t pushed = 0;
+    uint32_t evicted = 0;
+    uint32_t rejected = 0; // кадр больше бюджета или история заморожена
+    std::mutex lock;
+};
+
+// Прототипы функций
+bool jpegHistoryInit(JpegHistory &history, uint8_t *arena, size_t capacity, int frames);
+bool jpegHistoryPush(JpegHistory &history, const uint8_t *data, size_t len, uint32_t timestamp, uint32_t sequence);
+int jpegHistoryFreeze(JpegHistory &history);
+void jpegHistoryThaw(JpegHistory &history);
+const uint8_t *jpegHistoryFrame(const JpegHistory &history, int index, JpegHistoryEntry &entry);
+size_t jpegHistoryUsed(JpegHistory &history);
+
+#endif // JPEG_HISTORY_HPP
\ No newline at end of file
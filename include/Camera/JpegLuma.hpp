@@ -0,0 +1,19 @@
+/**
+ * @file JpegLuma.hpp
+ * @brief Получение кадра детекции из JPEG уменьшенным декодированием
+ *
+ * В однорежимном конвейере сенсор постоянно отдаёт SVGA JPEG, а
+ * полутоновый кадр детекции получается декодированием с масштабом
+ * 1/2, 1/4 или 1/8 и выборкой в сетку кадра детекции.
+ */
+
+#ifndef JPEG_LUMA_HPP
+#define JPEG_LUMA_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Прототипы функций
+bool jpegToLuma(const uint8_t *jpeg, size_t len, int sourceWidth, uint8_t *out, int outWidth, int outHeight);
+
+#endif // JPEG_LUMA_HPP
\ No newline at end of file
@@ -0,0 +1,67 @@
+/**
+ * @file SensorProfile.hpp
+ * @brief Именованные профили настроек сенсора с кэшем записанных значений
+ *
+ * Профиль - набор значений полей сенсора, применяемый одним пакетом.
+ * Кэш хранит последние записанные значения: поле, уже имеющее нужное
+ * значение, не записывается, а профиль, уже применённый целиком,
+ * пропускается без обращений к сенсору.
+ * Модуль не зависит от драйвера камеры: запись выполняет переданная
+ * функция, поэтому его можно проверять на хосте с имитацией сенсора.
+ */
+
+#ifndef SENSOR_PROFILE_HPP
+#define SENSOR_PROFILE_HPP
+
+#include <stdint.h>
+
+// Значение поля профиля "не менять"
+#define SENSOR_KEEP -1
+
+/**
+ * @brief Поля сенсора в порядке записи
+ */
+enum SensorField
+{
+    SENSOR_FRAMESIZE = 0,
+    SENSOR_PIXFORMAT,
+    SENSOR_QUALITY,
+    SENSOR_BRIGHTNESS,
+    SENSOR_GAINCEILING,
+    SENSOR_AEC2,
+    SENSOR_FIELD_COUNT
+};
+
+/**
+ * @brief Профиль: имя и значения полей
+ */
+struct SensorProfile
+{
+    const char *name;
+    int values[SENSOR_FIELD_COUNT];
+};
+
+/**
+ * @brief Кэш состояния сенсора и счётчики записей
+ */
+struct SensorCache
+{
+    int values[SENSOR_FIELD_COUNT];
+    bool known[SENSOR_FIELD_COUNT] = {false};
+    int profile = -1;         // применённый профиль, -1 - неизвестен
+    uint32_t writes = 0;      // выполненные записи полей
+    uint32_t elided = 0;      // записи, пропущенные по кэшу
+    uint32_t switches = 0;    // применения профиля с записью
+    uint32_t skipped = 0;     // применения, пропущенные целиком
+};
+
+// Запись одного поля в сенсор; false - запись не удалась
+typedef bool (*SensorWriter)(void *context, SensorField field, int value);
+
+// Прототипы функций
+int sensorProfileApply(SensorCache &cache, const SensorProfile &profile, int profileId,
+                       SensorWriter writer, void *context);
+void sensorCacheSeed(SensorCache &cache, SensorField field, int value);
+void sensorCacheInvalidate(SensorCache &cache);
+
+#endif // SENSOR_PROFILE_HPP
\ No newline at end of file
@@ -9,6 +9,22 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 
+// Максимальное число зон детекции (парковочных мест) в кадре
+#define MAX_DETECTION_ZONES 4
+
+/**
+ * @brief Зона детекции в координатах кадра детекции (160x120)
+ */
+struct DetectionZone
+{
+    int x = 40;
+    int y = 30;
+    int width = 80;
+    int height = 60;
+    int threshold = 160;
+    int area = 50;
+};
+
 /**
  * @brief Структура настроек системы
  */
@@ -20,12 +36,36 @@ struct Settings
     int area = 50;
     float dark_min = 0.2;
     float dark_max = 0.8;
-    float texture = 500.0;
-    int max_files = 250;
+    float texture = 0;       // наименьшая текстура зоны (градиентная энергия), 0 - выкл
+    int integral_mode = 0; // 0 - выкл, 1 - маска, 2 - маска и яркость
+    bool background = false; // детекция по разности с моделью фона
+    int bg_shift = 4;        // скорость обновления фона 2^-bg_shift
+    int fg_threshold = 25;   // отличие от фона для пикселя переднего плана
+    int motion_gate = 0;     // изменение ячейки сигнатуры для анализа кадра, 0 - выкл
+    bool blob = false;       // area применяется к наибольшей связной области
+    int stride = 1;          // шаг прореживания при анализе: 1, 2 или 4
+    int confirm_n = 2;       // голосов для смены состояния зоны ...
+    int confirm_m = 3;       // ... из стольких кадров
+    bool single_mode = false; // сенсор всегда в SVGA JPEG, кадр детекции декодируется из него
+    int history_frames = 8;      // кадров истории до срабатывания, 0 - выкл
+    int history_kb = 512;        // бюджет памяти истории, КБ
+    int history_interval = 250;  // наименьший интервал между кадрами истории, мс
+    int burst_frames = 1;        // кадров в серии для выбора самого резкого, 1 - выкл
+    bool burst_fine = false;     // оценка резкости по 1/4 кадра вместо 1/8
+    int max_frame_age = 200;     // допустимый возраст кадра, мс; 0 - без ограничения
+    int settle_max = 1500;       // предел ожидания экспозиции после смены режима, мс
+    int settle_tolerance = 2;    // изменение средней яркости установившегося кадра
+    bool night_mode = false;     // детекция в ночном профиле сенсора
+    int storage_policy = 0;      // заполненная очередь записи: 0 - отбросить старое, 1 - ждать
+    int max_files = 250;         // фотографий в архиве, 0 - без ограничения
+    int min_free_percent = 0;    // свободного места на карте, %; 0 - не проверять
     int roi_width = 80;
     int roi_height = 60;
     int roi_x = 40;
     int roi_y = 30;
+    // Зона 0 всегда совпадает с roi_* / threshold / area
+    DetectionZone zones[MAX_DETECTION_ZONES];
+    int zone_count = 1;
     String ap_ssid = "CarDetector";
     String ap_password = "12345678";
 };
@@ -0,0 +1,40 @@
+/**
+ * @file BackgroundModel.hpp
+ * @brief Попиксельная модель фона для детекции по разности с фоном
+ *
+ * Фон хранится как экспоненциальное скользящее среднее яркости в формате
+ * 8.8 с фиксированной точкой (uint16_t на пиксель, 38 КБ для 160x120).
+ */
+
+#ifndef BACKGROUND_MODEL_HPP
+#define BACKGROUND_MODEL_HPP
+
+#include <stdint.h>
+#include "Detection/FrameKernels.hpp"
+
+// Допустимый показатель скорости обновления фона 2^-shift: при 0 фон
+// заменяется кадром, при 16 и больше приращение в формате 8.8 всегда 0
+#define BG_SHIFT_MIN 1
+#define BG_SHIFT_MAX 8
+
+/**
+ * @brief Состояние модели фона
+ */
+struct BackgroundModel
+{
+    int width = 0;
+    int height = 0;
+    uint16_t *mean = nullptr;
+    bool seeded = false;
+};
+
+// Прототипы функций
+bool backgroundModelInit(BackgroundModel &model, int width, int height);
+void backgroundModelFree(BackgroundModel &model);
+void backgroundModelSeed(BackgroundModel &model, const uint8_t *image);
+uint32_t backgroundModelProcess(BackgroundModel &model, const uint8_t *image, const PixelRect &region,
+                                int foregroundThreshold, int alphaShift, bool update);
+void backgroundModelMaskRow(const BackgroundModel &model, const uint8_t *image, int y, int x0, int length,
+                            int foregroundThreshold, uint8_t *mask);
+
+#endif // BACKGROUND_MODEL_HPP
\ No newline at end of file
@@ -0,0 +1,62 @@
+/**
+ * @file BlobLabeler.hpp
+ * @brief Выделение связных областей (блобов) по сериям пикселей строк
+ *
+ * Маска обрабатывается построчно: каждая строка разбивается на серии
+ * соседних пикселей, серии объединяются с пересекающимися сериями
+ * предыдущей строки (8-связность) через систему непересекающихся
+ * множеств. Таблица серий выделяется по размеру наибольшей зоны при
+ * её изменении, на кадр память не выделяется.
+ */
+
+#ifndef BLOB_LABELER_HPP
+#define BLOB_LABELER_HPP
+
+#include <stdint.h>
+
+// Предел таблицы серий: номера серий хранятся в uint16_t
+#define BLOB_MAX_RUNS 65535
+
+/**
+ * @brief Параметры связной области
+ */
+struct BlobInfo
+{
+    uint32_t area = 0;
+    int minX = 0;
+    int minY = 0;
+    int maxX = 0;
+    int maxY = 0;
+    float centroidX = 0;
+    float centroidY = 0;
+};
+
+/**
+ * @brief Таблица серий и состояние разметки
+ */
+struct BlobLabeler
+{
+    uint16_t *parent = nullptr;
+    uint16_t *start = nullptr;
+    uint16_t *end = nullptr;
+    uint16_t *row = nullptr;
+    uint32_t *area = nullptr;
+    int capacity = 0;
+    int runCount = 0;
+    int prevStart = 0;
+    int prevEnd = 0;
+    int lastY = -2;
+    uint32_t pixels = 0;
+    bool overflow = false;
+};
+
+// Прототипы функций
+int blobRunCapacity(int width, int height);
+bool blobLabelerInit(BlobLabeler &labeler, int capacity);
+void blobLabelerFree(BlobLabeler &labeler);
+void blobLabelerReset(BlobLabeler &labeler);
+void blobAddDarkRow(BlobLabeler &labeler, const uint8_t *row, int x0, int length, int y, int threshold);
+void blobAddMaskRow(BlobLabeler &labeler, const uint8_t *mask, int x0, int length, int y);
+bool blobLargest(BlobLabeler &labeler, BlobInfo &blob);
+
+#endif // BLOB_LABELER_HPP
\ No newline at end of file
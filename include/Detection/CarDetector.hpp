@@ -7,10 +7,12 @@
 #define CAR_DETECTOR_HPP
 
 #include <esp_camera.h>
+#include "Config/Config.hpp"
+#include "Detection/FrameAnalyzer.hpp"
 
 // Прототипы функций
-void detectCar();
-int analyzeFrame(camera_fb_t *fb, int &darkPixels, int &totalPixels, float &darkRatio);
-void takeHighQualityPhoto(int darkPixels, int totalPixels, float darkRatio);
+bool detectCar();
+uint32_t analyzeFrame(camera_fb_t *fb);
+void takeHighQualityPhoto(uint32_t zoneMask);
 
 #endif // CAR_DETECTOR_HPP
\ No newline at end of file
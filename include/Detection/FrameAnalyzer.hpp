@@ -0,0 +1,53 @@
+/**
+ * @file FrameAnalyzer.hpp
+ * @brief Анализ полутонового кадра по зонам детекции
+ *
+ * Модуль не зависит от камеры, SD карты и веб-сервера: принимает буфер
+ * кадра и расстояние и ведёт состояние зон, поэтому собирается на хосте
+ * для воспроизведения записанных кадров (test/replay).
+ */
+
+#ifndef FRAME_ANALYZER_HPP
+#define FRAME_ANALYZER_HPP
+
+#include <stdint.h>
+#include "Config/Config.hpp"
+#include "Detection/IntegralImage.hpp"
+#include "Detection/Histogram.hpp"
+#include "Detection/BlobLabeler.hpp"
+#include "Detection/MotionGate.hpp"
+#include "Detection/OccupancyTracker.hpp"
+
+/**
+ * @brief Состояние зоны детекции по результатам последнего кадра
+ */
+struct ZoneState
+{
+    bool occupied = false;
+    bool vote = false; // голос последнего проанализированного кадра
+    OccupancyTracker tracker;
+    int darkPixels = 0;
+    int totalPixels = 0;
+    float darkRatio = 0;
+    float texture = 0;
+    int threshold = 0;
+    int autoThreshold = 0; // последний надёжный порог Оцу, 0 - ещё не найден
+    bool hasHistogram = false;
+    HistogramStats histogram;
+    bool hasBlob = false;
+    BlobInfo blob;
+};
+
+// Внешнее объявление состояния зон и фильтра статичных кадров
+extern ZoneState zoneStates[MAX_DETECTION_ZONES];
+extern MotionGate motionGate;
+
+// Прототипы функций
+uint32_t analyzeImage(const uint8_t *buf, int frameWidth, int frameHeight, int distance);
+uint32_t detectInFrame(const uint8_t *buf, int width, int height, int distance, bool &analyzed);
+bool zonesVoting();
+bool zonesOccupied();
+void resetZones();
+bool getRegionStats(int x, int y, int width, int height, RegionStats &stats);
+
+#endif // FRAME_ANALYZER_HPP
\ No newline at end of file
@@ -0,0 +1,41 @@
+/**
+ * @file FrameKernels.hpp
+ * @brief Вычислительные ядра анализа кадра в оттенках серого
+ *
+ * Модуль не зависит от Arduino и esp_camera, поэтому может собираться
+ * и проверяться на хосте.
+ */
+
+#ifndef FRAME_KERNELS_HPP
+#define FRAME_KERNELS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Кадр детекции (режим FRAMESIZE_QQVGA камеры)
+#define DETECTION_FRAME_WIDTH 160
+#define DETECTION_FRAME_HEIGHT 120
+
+/**
+ * @brief Прямоугольная область кадра с порогом яркости
+ */
+struct PixelRect
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int threshold;
+};
+
+// Прототипы функций
+uint32_t countDarkPixelsRow(const uint8_t *row, int length, int threshold);
+uint32_t countDarkPixels(const uint8_t *image, int stride, int x, int y, int width, int height, int threshold);
+void countDarkPixelsRegions(const uint8_t *image, int stride, const PixelRect *regions, int regionCount, uint32_t *counts);
+void decimateFrame(const uint8_t *image, int width, int step, const PixelRect &area, uint8_t *out, int outWidth);
+void analyzeRegionsTexture(const uint8_t *image, int stride, const PixelRect *regions, int regionCount,
+                           uint32_t *counts, float *textures, uint32_t *const *histograms);
+float laplacianVariance(const uint8_t *image, int width, int height);
+uint32_t meanLuma(const uint8_t *image, size_t count, int step);
+
+#endif // FRAME_KERNELS_HPP
\ No newline at end of file
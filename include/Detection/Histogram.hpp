@@ -0,0 +1,47 @@
+/**
+ * @file Histogram.hpp
+ * @brief Гистограмма яркости области и адаптивный порог по методу Оцу
+ */
+
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <stdint.h>
+#include "Detection/FrameKernels.hpp"
+
+#define HISTOGRAM_BINS 256
+
+// Порог Оцу разбивает на два класса любую область, в том числе однородную
+// пустую площадку; он принимается, только если классы действительно
+// различаются: средние классов расходятся не меньше чем на
+// OTSU_MIN_SEPARATION уровней яркости, а межклассовая дисперсия составляет
+// не меньше OTSU_MIN_EFFECTIVENESS общей (у одного нормального
+// распределения это 0.64, у равномерного - 0.75)
+#define OTSU_MIN_SEPARATION 24
+#define OTSU_MIN_EFFECTIVENESS 0.8f
+
+/**
+ * @brief Статистика яркости по гистограмме
+ */
+struct HistogramStats
+{
+    uint32_t totalPixels = 0;
+    float mean = 0;
+    float variance = 0;
+    uint8_t p10 = 0;
+    uint8_t p50 = 0;
+    uint8_t p90 = 0;
+    int otsuThreshold = 0;
+    float otsuSeparation = 0;     // разность средних светлого и тёмного классов
+    float otsuEffectiveness = 0;  // доля межклассовой дисперсии в общей
+    bool otsuReliable = false;    // классы различаются, порогу можно доверять
+};
+
+// Прототипы функций
+void buildHistogram(const uint8_t *image, int stride, const PixelRect &region, uint32_t *bins);
+int otsuThreshold(const uint32_t *bins);
+int otsuThreshold(const uint32_t *bins, float &separation, float &betweenVariance);
+uint32_t histogramCountBelow(const uint32_t *bins, int threshold);
+void histogramStats(const uint32_t *bins, HistogramStats &stats);
+
+#endif // HISTOGRAM_HPP
\ No newline at end of file
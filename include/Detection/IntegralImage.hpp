@@ -0,0 +1,55 @@
+/**
+ * @file IntegralImage.hpp
+ * @brief Интегральное изображение (summed-area table) кадра детекции
+ *
+ * После построения таблицы число тёмных пикселей, средняя яркость и доля
+ * тёмных пикселей любого прямоугольника вычисляются за четыре обращения.
+ */
+
+#ifndef INTEGRAL_IMAGE_HPP
+#define INTEGRAL_IMAGE_HPP
+
+#include <stdint.h>
+
+/**
+ * @brief Режимы построения интегрального изображения
+ */
+enum IntegralMode
+{
+    INTEGRAL_OFF = 0,
+    INTEGRAL_MASK = 1,
+    INTEGRAL_MASK_LUMA = 2
+};
+
+/**
+ * @brief Таблицы сумм размером (width + 1) x (height + 1)
+ */
+struct IntegralImage
+{
+    int width = 0;
+    int height = 0;
+    int threshold = 0;
+    uint32_t *mask = nullptr;
+    uint32_t *luma = nullptr;
+};
+
+/**
+ * @brief Статистика прямоугольной области
+ */
+struct RegionStats
+{
+    uint32_t totalPixels = 0;
+    uint32_t darkPixels = 0;
+    float darkRatio = 0;
+    float meanLuma = 0;
+};
+
+// Прототипы функций
+bool integralImageInit(IntegralImage &ii, int width, int height, bool withLuma);
+void integralImageFree(IntegralImage &ii);
+void integralImageBuild(IntegralImage &ii, const uint8_t *image, int threshold);
+uint32_t integralImageDarkCount(const IntegralImage &ii, int x, int y, int width, int height);
+uint32_t integralImageLumaSum(const IntegralImage &ii, int x, int y, int width, int height);
+bool integralImageStats(const IntegralImage &ii, int x, int y, int width, int height, RegionStats &stats);
+
+#endif // INTEGRAL_IMAGE_HPP
\ No newline at end of file
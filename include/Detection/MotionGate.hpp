@@ -0,0 +1,35 @@
+/**
+ * @file MotionGate.hpp
+ * @brief Предварительная проверка изменений сцены между кадрами
+ *
+ * Кадр сводится к грубой сигнатуре 16x12 ячеек; если ни одна ячейка не
+ * изменилась относительно последнего проанализированного кадра больше
+ * чем на заданную величину, полный анализ кадра пропускается.
+ */
+
+#ifndef MOTION_GATE_HPP
+#define MOTION_GATE_HPP
+
+#include <stdint.h>
+
+#define MOTION_SIGNATURE_COLS 16
+#define MOTION_SIGNATURE_ROWS 12
+#define MOTION_SIGNATURE_SIZE (MOTION_SIGNATURE_COLS * MOTION_SIGNATURE_ROWS)
+
+/**
+ * @brief Состояние фильтра и счётчики кадров
+ */
+struct MotionGate
+{
+    uint8_t reference[MOTION_SIGNATURE_SIZE];
+    bool hasReference = false;
+    uint32_t framesGated = 0;
+    uint32_t framesAnalyzed = 0;
+};
+
+// Прототипы функций
+void motionSignature(const uint8_t *image, int width, int height, uint8_t *signature);
+bool motionGateCheck(MotionGate &gate, const uint8_t *image, int width, int height, int sensitivity);
+void motionGateReset(MotionGate &gate);
+
+#endif // MOTION_GATE_HPP
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * @file OccupancyTracker.hpp
+ * @brief Автомат состояний занятости зоны с голосованием N из M
+ *
+ * EMPTY -> ARRIVING -> OCCUPIED -> LEAVING -> EMPTY. Переход в OCCUPIED
+ * требует N положительных голосов из M кадров после первого, переход
+ * в EMPTY - N отрицательных голосов из M. Одиночный шумный кадр не
+ * вызывает ни съёмки, ни освобождения зоны.
+ */
+
+#ifndef OCCUPANCY_TRACKER_HPP
+#define OCCUPANCY_TRACKER_HPP
+
+#include <stdint.h>
+
+// Наибольшая длина окна голосования
+#define OCCUPANCY_MAX_WINDOW 16
+
+/**
+ * @brief Состояния зоны
+ */
+enum OccupancyState
+{
+    ZONE_EMPTY = 0,
+    ZONE_ARRIVING,
+    ZONE_OCCUPIED,
+    ZONE_LEAVING
+};
+
+/**
+ * @brief События, возникающие при смене состояния
+ */
+enum OccupancyEvent
+{
+    OCCUPANCY_NONE = 0,
+    OCCUPANCY_ARRIVED,
+    OCCUPANCY_DEPARTED
+};
+
+/**
+ * @brief Состояние автомата зоны
+ */
+struct OccupancyTracker
+{
+    OccupancyState state = ZONE_EMPTY;
+    uint16_t votes = 0;  // голоса с момента входа в состояние, бит 0 - последний
+    uint8_t samples = 0; // число голосов с момента входа в состояние
+};
+
+// Прототипы функций
+OccupancyEvent occupancyUpdate(OccupancyTracker &tracker, bool present, int n, int m);
+void occupancyReset(OccupancyTracker &tracker);
+bool occupancyIsOccupied(const OccupancyTracker &tracker);
+const char *occupancyStateName(OccupancyState state);
+
+#endif // OCCUPANCY_TRACKER_HPP
\ No newline at end of file
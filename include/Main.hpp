@@ -26,6 +26,7 @@ extern bool camera_initialized;
 extern bool car_detected;
 extern unsigned long timeInterval;
 extern unsigned long timeblink;
+extern unsigned long timeVote;
 
 // Прототипы функций
 void setup();
@@ -0,0 +1,83 @@
+/**
+ * @file EventLog.hpp
+ * @brief Журнал событий детекции в одном файле
+ *
+ * Метаданные каждой фотографии дописываются в /events.log записью
+ * фиксированного размера: заголовок с номером события, длиной и
+ * контрольной суммой, затем JSON, дополненный до размера записи. Записи
+ * идут по возрастанию номера, поэтому событие находится двоичным поиском
+ * по смещениям без чтения всего файла. Оборванная при сбое питания
+ * последняя запись отбрасывается при открытии.
+ */
+
+#ifndef EVENT_LOG_HPP
+#define EVENT_LOG_HPP
+
+#include <Arduino.h>
+
+#define EVENT_LOG_PATH "/events.log"
+#define EVENT_LOG_TEMP_PATH "/events.tmp"
+
+// Размер записи кратен сектору SD карты
+#define EVENT_RECORD_SIZE 2048
+#define EVENT_RECORD_MAGIC 0x31545645 // "EVT1"
+
+// Сброс буферов файла на карту: после стольких записей или по таймеру, мс
+#define EVENT_LOG_SYNC_RECORDS 8
+#define EVENT_LOG_SYNC_MS 5000
+
+// Журнал переписывается без удалённых событий, когда их набирается столько
+#define EVENT_LOG_COMPACT_RECORDS 256
+
+/**
+ * @brief Заголовок записи журнала
+ */
+struct EventRecordHeader
+{
+    uint32_t magic;
+    uint32_t id;       // номер события (номер фотографии)
+    uint16_t length;   // длина JSON
+    uint16_t checksum; // Fletcher-16 по JSON
+    uint32_t reserved;
+};
+
+// Наибольшая длина JSON в записи
+#define EVENT_PAYLOAD_MAX (EVENT_RECORD_SIZE - sizeof(EventRecordHeader))
+
+/**
+ * @brief Позиция чтения журнала
+ */
+struct EventLogCursor
+{
+    uint32_t index = 0; // номер следующей записи
+};
+
+/**
+ * @brief Состояние журнала
+ */
+struct EventLogStats
+{
+    uint32_t records = 0;
+    uint32_t firstId = 0;
+    uint32_t lastId = 0;
+    uint32_t appended = 0;
+    uint32_t syncs = 0;
+    uint32_t imported = 0;
+    uint32_t floorId = 0;  // события с меньшим номером удалены из архива
+    uint32_t compactions = 0;
+};
+
+extern EventLogStats eventLogStats;
+
+// Прототипы функций
+bool eventLogOpen();
+bool eventLogAppend(uint32_t id, const String &json);
+void eventLogSync(bool force);
+bool eventLogRead(uint32_t index, uint32_t &id, String &json);
+bool eventLogFind(uint32_t id, String &json);
+void eventLogSeek(EventLogCursor &cursor, uint32_t id);
+bool eventLogNext(EventLogCursor &cursor, uint32_t &id, String &json);
+int eventLogImportLegacy();
+void eventLogTrim(uint32_t floorId);
+
+#endif // EVENT_LOG_HPP
\ No newline at end of file
@@ -0,0 +1,32 @@
+/**
+ * @file PhotoArchive.hpp
+ * @brief Раскладка архива фотографий по каталогам
+ *
+ * Фотографии хранятся в каталогах по PHOTO_BUCKET_SIZE номеров:
+ * /events/<номер / 1000>/car_NNNNN.jpg. Путь вычисляется по номеру
+ * фотографии, поэтому веб-интерфейс обращается к файлу по имени без
+ * обхода каталогов.
+ */
+
+#ifndef PHOTO_ARCHIVE_HPP
+#define PHOTO_ARCHIVE_HPP
+
+#include <Arduino.h>
+#include <vector>
+
+#define PHOTO_ARCHIVE_ROOT "/events"
+#define PHOTO_BUCKET_SIZE 1000
+
+// Прототипы функций
+String photoBucketPath(uint32_t id);
+String photoPath(uint32_t id);
+String photoName(uint32_t id);
+String photoPrePath(uint32_t id, int index);
+bool photoIdFromName(const String &name, uint32_t &id);
+String photoResolve(const String &name);
+bool photoArchiveEnsureDir(const String &path);
+bool photoArchiveOldest(uint32_t &id);
+bool photoArchiveDelete(const String &name);
+int photoArchiveMigrate();
+
+#endif // PHOTO_ARCHIVE_HPP
\ No newline at end of file
@@ -0,0 +1,63 @@
+/**
+ * @file PhotoIndex.hpp
+ * @brief Индекс фотографий архива на карте
+ *
+ * /photos.idx - заголовок и записи фиксированного размера по возрастанию
+ * номера: номер, размер JPEG, время срабатывания и основные метрики.
+ * Запись добавляется при сохранении фотографии и помечается при удалении,
+ * поэтому галерея читает последние записи с конца файла, не обходя
+ * каталоги и не открывая фотографии. Индекс перестраивается по архиву,
+ * только если файла нет или он испорчен.
+ */
+
+#ifndef PHOTO_INDEX_HPP
+#define PHOTO_INDEX_HPP
+
+#include <Arduino.h>
+
+#define PHOTO_INDEX_PATH "/photos.idx"
+#define PHOTO_INDEX_TEMP_PATH "/photos.tmp"
+#define PHOTO_INDEX_MAGIC 0x31584950 // "PIX1"
+
+// Флаги записи
+#define PHOTO_INDEX_DELETED 0x01
+
+// Индекс переписывается без удалённых записей в начале, когда их столько
+#define PHOTO_INDEX_COMPACT 256
+
+/**
+ * @brief Запись индекса
+ */
+struct PhotoIndexEntry
+{
+    uint32_t id = 0;
+    uint32_t size = 0;         // размер JPEG, байт
+    uint32_t uptime = 0;       // время срабатывания от запуска, мс (часов реального времени нет)
+    uint16_t distance = 0;     // показание датчика расстояния
+    uint16_t darkPermille = 0; // доля тёмных пикселей зоны, 1/1000
+    uint8_t zone = 0;
+    uint8_t flags = 0;
+    uint16_t checksum = 0;     // Fletcher-16 по предыдущим полям
+};
+
+/**
+ * @brief Состояние индекса
+ */
+struct PhotoIndexStats
+{
+    uint32_t entries = 0; // записей в файле, включая удалённые
+    uint32_t live = 0;    // записей неудалённых фотографий
+    uint32_t rebuilds = 0;
+    uint32_t compactions = 0;
+};
+
+extern PhotoIndexStats photoIndexStats;
+
+// Прототипы функций
+bool photoIndexOpen();
+bool photoIndexAppend(PhotoIndexEntry &entry);
+bool photoIndexRemove(uint32_t id);
+int photoIndexNewest(PhotoIndexEntry *entries, int limit);
+uint16_t photoIndexPermille(float ratio);
+
+#endif // PHOTO_INDEX_HPP
\ No newline at end of file
@@ -0,0 +1,36 @@
+/**
+ * @file Retention.hpp
+ * @brief Ограничение архива фотографий по числу и свободному месту
+ *
+ * Номера фотографий идут подряд, поэтому архив описывается диапазоном
+ * [oldestId, photoNumber): самая старая фотография известна без обхода
+ * карты, а её путь вычисляется по номеру. Удаление выполняет задача
+ * записи, детекцию оно не задерживает.
+ */
+
+#ifndef RETENTION_HPP
+#define RETENTION_HPP
+
+#include <Arduino.h>
+
+// Наибольшее число удалений за один вызов, чтобы не задерживать запись
+#define RETENTION_BATCH 16
+
+/**
+ * @brief Состояние ограничения архива
+ */
+struct RetentionStats
+{
+    uint32_t oldestId = 1;   // самый старый номер, который может быть в архиве
+    uint32_t evicted = 0;    // удалённые фотографии
+    uint32_t missing = 0;    // номера без файла (удалены вручную, не записаны)
+    int freePercent = -1;    // свободное место при последней проверке, -1 - не проверялось
+};
+
+extern RetentionStats retentionStats;
+
+// Прототипы функций
+void setupRetention();
+int retentionEnforce();
+
+#endif // RETENTION_HPP
\ No newline at end of file
@@ -0,0 +1,20 @@
+/**
+ * @file RetentionRange.hpp
+ * @brief Правила ограничения архива по диапазону номеров фотографий
+ *
+ * Архив описывается диапазоном номеров [oldest, newest]; пропуски
+ * считаются занятыми номерами. Модуль не зависит от Arduino и SD_MMC,
+ * поэтому может собираться и проверяться на хосте.
+ */
+
+#ifndef RETENTION_RANGE_HPP
+#define RETENTION_RANGE_HPP
+
+#include <stdint.h>
+
+// Прототипы функций
+uint32_t retentionRangeCount(uint32_t oldest, uint32_t newest);
+bool retentionOverCount(uint32_t oldest, uint32_t newest, int maxFiles);
+bool retentionMayFreeSpace(uint32_t oldest, uint32_t newest, int minFreePercent);
+
+#endif // RETENTION_RANGE_HPP
\ No newline at end of file
@@ -14,6 +14,7 @@
 // Прототипы функций
 bool setupSDCard();
 bool savePhotoToSD(const char *filename, camera_fb_t *fb, const DynamicJsonDocument &doc);
+bool saveJpegToSD(const String &path, const uint8_t *data, size_t len);
 bool verifyFile(const String &path, size_t expectedSize);
 String listFiles();
 
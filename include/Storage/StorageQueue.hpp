@@ -0,0 +1,51 @@
+/**
+ * @file StorageQueue.hpp
+ * @brief Ограниченная очередь записи с поведением при заполнении
+ *
+ * Очередь указателей на записи: детекция ставит, задача записи забирает.
+ * При заполнении новая запись либо вытесняет самую старую, либо ждёт
+ * места ограниченное время. Модуль не зависит от Arduino и FreeRTOS
+ * (std::mutex, std::condition_variable), поэтому может собираться и
+ * проверяться на хосте.
+ */
+
+#ifndef STORAGE_QUEUE_HPP
+#define STORAGE_QUEUE_HPP
+
+#include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+
+// Наибольшая длина очереди
+#define STORAGE_QUEUE_MAX 16
+
+/**
+ * @brief Поведение при заполненной очереди
+ */
+enum StoragePolicy
+{
+    STORAGE_DROP_OLDEST = 0, // самая старая запись отбрасывается
+    STORAGE_BLOCK            // ожидание места до заданного предела
+};
+
+/**
+ * @brief Кольцо указателей на записи
+ */
+struct StorageQueue
+{
+    void *items[STORAGE_QUEUE_MAX];
+    int capacity = 0;
+    int first = 0;
+    int count = 0;
+    uint32_t depthMax = 0; // наибольшая глубина очереди
+    std::mutex lock;
+    std::condition_variable changed;
+};
+
+// Прототипы функций
+void storageQueueInit(StorageQueue &queue, int capacity);
+bool storageQueuePush(StorageQueue &queue, void *item, StoragePolicy policy, uint32_t timeoutMs, void *&dropped);
+bool storageQueuePop(StorageQueue &queue, void *&item, uint32_t timeoutMs);
+int storageQueueCount(StorageQueue &queue);
+
+#endif // STORAGE_QUEUE_HPP
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ * @file StorageWriter.hpp
+ * @brief Фоновая запись фотографий на SD карту
+ *
+ * Детекция ставит в очередь копию JPEG и готовые метаданные и сразу
+ * продолжает работу; задача записи сохраняет JPEG на карту, метаданные -
+ * в журнал событий и индекс фотографий, и учитывает результат в
+ * счётчиках. Очередь ограничена, поведение при заполнении задаёт
+ * настройка storage_policy.
+ */
+
+#ifndef STORAGE_WRITER_HPP
+#define STORAGE_WRITER_HPP
+
+#include <Arduino.h>
+#include <atomic>
+#include <vector>
+#include "Storage/PhotoIndex.hpp"
+#include "Storage/StorageQueue.hpp"
+
+// Задача записи: ядро детекции и захвата занято, запись - на ядре Arduino
+#define STORAGE_TASK_CORE 1
+#define STORAGE_TASK_PRIORITY 1
+#define STORAGE_TASK_STACK 6144
+
+// Длина очереди записи в событиях и ожидание места в режиме STORAGE_BLOCK, мс
+#define STORAGE_QUEUE_LENGTH 8
+#define STORAGE_BLOCK_TIMEOUT 2000
+
+/**
+ * @brief Данные JPEG, общие для нескольких записей
+ *
+ * Фотография всех сработавших зон сохраняется под разными номерами из
+ * одной копии; память освобождается с последней ссылкой.
+ */
+struct StorageBlob
+{
+    uint8_t *data;
+    size_t len;
+    std::atomic<int> refs;
+};
+
+/**
+ * @brief Кадр истории до срабатывания
+ */
+struct StorageFrame
+{
+    String path;
+    StorageBlob *blob;
+    int32_t offset; // смещение от срабатывания, мс
+};
+
+/**
+ * @brief Фотография события для одной зоны
+ *
+ * Метаданные - без списка кадров истории: его добавляет задача записи
+ * по кадрам, которые действительно записаны.
+ */
+struct StoragePhoto
+{
+    String path;
+    PhotoIndexEntry entry;
+    String metadata;
+};
+
+/**
+ * @brief Событие - одна запись очереди
+ *
+ * Кадры истории и фотографии всех сработавших зон ставятся вместе,
+ * поэтому заполненная очередь не разделяет событие: оно принимается или
+ * отбрасывается целиком.
+ */
+struct StorageEvent
+{
+    StorageBlob *photo = nullptr;
+    std::vector<StorageFrame> frames;
+    std::vector<StoragePhoto> photos;
+};
+
+/**
+ * @brief Счётчики записи
+ *
+ * queued и dropped считают события и меняются только детекцией,
+ * остальные считают файлы и меняются только задачей записи.
+ */
+struct StorageStats
+{
+    uint32_t queued = 0;    // принятые события
+    uint32_t written = 0;   // сохранённые файлы
+    uint32_t failed = 0;    // ошибки записи файлов
+    uint32_t dropped = 0;   // события, отброшенные из-за заполненной очереди или памяти
+    uint32_t depthMax = 0;  // наибольшая глубина очереди
+    uint32_t lastMs = 0;    // длительность записи последнего события, мс
+};
+
+extern StorageStats storageStats;
+
+// Прототипы функций
+bool startStorageTask();
+StorageBlob *storageBlobCreate(const uint8_t *data, size_t len);
+void storageBlobRelease(StorageBlob *blob);
+void storageEventFree(StorageEvent *event);
+bool storageEnqueue(StorageEvent *event);
+int storageQueueDepth();
+
+#endif // STORAGE_WRITER_HPP
\ No newline at end of file
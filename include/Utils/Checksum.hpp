@@ -0,0 +1,15 @@
+/**
+ * @file Checksum.hpp
+ * @brief Контрольные суммы записей на карте
+ */
+
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Прототипы функций
+uint16_t fletcher16(const uint8_t *data, size_t len);
+
+#endif // CHECKSUM_HPP
\ No newline at end of file
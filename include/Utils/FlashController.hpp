@@ -15,5 +15,6 @@ void setupFlash();
 void onFlash();
 void offFlash();
 void reverseFlash();
+uint32_t flashOffTime();
 
 #endif // FLASH_CONTROLLER_HPP
\ No newline at end of file
@@ -17,8 +17,17 @@ void handleROISettings();
 void handleSaveDetection();
 void handleSaveWifi();
 void handleSaveROI();
+void handleSaveZones();
+void handleROIStats();
+void handleHistogram();
+void handleFrameAge();
+void handleCameraProfiles();
+void handleEvent();
+void handleEvents();
 void handleListPhotos();
 void handleDeletePhoto();
+void handleDownloadPhoto();
+void handleListFiles();
 
 void handleStream();
 void handleCapture();
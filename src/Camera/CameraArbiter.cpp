@@ -0,0 +1,165 @@
+/**
+ * @file CameraArbiter.cpp
+ * @brief Реализация распределения режимов камеры
+ */
+
+#include "Camera/CameraArbiter.hpp"
+#include <chrono>
+
+/**
+ * @brief Инициализация арбитра
+ * @param base Профиль свободной камеры; не применяется при инициализации
+ * @param apply Функция применения профиля к сенсору
+ */
+void cameraArbiterInit(CameraArbiter &arbiter, int base, ProfileApplier apply, void *context)
+{
+    std::lock_guard<std::mutex> guard(arbiter.lock);
+    arbiter.base = base;
+    arbiter.active = -1;
+    arbiter.holders = 0;
+    for (int i = 0; i < OWNER_COUNT; i++)
+    {
+        arbiter.holds[i] = 0;
+        arbiter.waiting[i] = 0;
+        arbiter.stats[i] = CameraOwnerStats();
+    }
+    arbiter.apply = apply;
+    arbiter.context = context;
+}
+
+/**
+ * @brief Ждёт ли камеру владелец важнее owner
+ */
+static bool higherWaiting(const CameraArbiter &arbiter, CameraOwner owner)
+{
+    for (int i = 0; i < owner; i++)
+    {
+        if (arbiter.waiting[i] > 0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Запрос камеры в заданном профиле
+ *
+ * Профиль, совпадающий с удерживаемым, разделяется без переключения.
+ * Иначе запрос ждёт освобождения камеры всеми владельцами. Пока камеру
+ * ждёт более важный владелец, запрос не удовлетворяется даже в том же
+ * профиле.
+ * @param timeoutMs Предел ожидания, мс
+ * @param switched Если не nullptr - true, когда сенсор переведён из
+ * профиля свободной камеры в другой и экспозиция ещё не установилась
+ * @return true - камера удерживается в профиле, нужен cameraArbiterRelease
+ */
+bool cameraArbiterAcquire(CameraArbiter &arbiter, CameraOwner owner, int profile, uint32_t timeoutMs,
+                          bool *switched)
+{
+    std::unique_lock<std::mutex> guard(arbiter.lock);
+    CameraOwnerStats &stats = arbiter.stats[owner];
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (switched)
+        *switched = false;
+
+    arbiter.waiting[owner]++;
+    bool ready = arbiter.released.wait_for(guard, std::chrono::milliseconds(timeoutMs), [&arbiter, owner, profile]
+                                           { return !higherWaiting(arbiter, owner) &&
+                                                    (arbiter.holders == 0 || arbiter.active == profile); });
+    // Менее важные запросы могли ждать только этот
+    arbiter.waiting[owner]--;
+    arbiter.released.notify_all();
+
+    uint32_t waited = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start).count();
+    stats.waitTotal += waited;
+    if (waited > stats.waitMax)
+        stats.waitMax = waited;
+
+    if (!ready)
+    {
+        stats.timeouts++;
+        return false;
+    }
+
+    if (arbiter.holders > 0)
+    {
+        stats.coalesced++;
+    }
+    else
+    {
+        if (!arbiter.apply(arbiter.context, profile))
+        {
+            // Частично применённый профиль заменяется базовым
+            arbiter.apply(arbiter.context, arbiter.base);
+            return false;
+        }
+        arbiter.active = profile;
+        if (profile != arbiter.base)
+        {
+            stats.switches++;
+            if (switched)
+                *switched = true;
+        }
+    }
+
+    arbiter.holders++;
+    arbiter.holds[owner]++;
+    stats.requests++;
+    return true;
+}
+
+/**
+ * @brief Освобождение камеры владельцем
+ *
+ * Последнее освобождение возвращает камеру в базовый профиль и будит
+ * ожидающие запросы.
+ */
+void cameraArbiterRelease(CameraArbiter &arbiter, CameraOwner owner)
+{
+    std::lock_guard<std::mutex> guard(arbiter.lock);
+    if (arbiter.holds[owner] == 0)
+        return;
+
+    arbiter.holds[owner]--;
+    if (--arbiter.holders == 0)
+    {
+        if (arbiter.active != arbiter.base)
+            arbiter.apply(arbiter.context, arbiter.base);
+        arbiter.active = -1;
+        arbiter.released.notify_all();
+    }
+}
+
+/**
+ * @brief Должен ли владелец уступить камеру более важному
+ *
+ * Длительный владелец (поток) проверяет это между кадрами и при true
+ * освобождает камеру и запрашивает её снова.
+ */
+bool cameraArbiterPreempted(CameraArbiter &arbiter, CameraOwner owner)
+{
+    std::lock_guard<std::mutex> guard(arbiter.lock);
+    return arbiter.holds[owner] > 0 && higherWaiting(arbiter, owner);
+}
+
+/**
+ * @brief Смена базового профиля
+ *
+ * Свободная камера переключается сразу, занятая - при освобождении.
+ */
+void cameraArbiterSetBase(CameraArbiter &arbiter, int base)
+{
+    std::lock_guard<std::mutex> guard(arbiter.lock);
+    arbiter.base = base;
+    if (arbiter.holders == 0)
+        arbiter.apply(arbiter.context, base);
+}
+
+/**
+ * @brief Имя владельца камеры
+ */
+const char *cameraOwnerName(int owner)
+{
+    static const char *names[OWNER_COUNT] = {"detector", "snapshot", "stream"};
+    return owner >= 0 && owner < OWNER_COUNT ? names[owner] : "unknown";
+}
\ No newline at end of file
@@ -5,10 +5,49 @@
 
 #include <Arduino.h>
 #include "Camera/CameraController.hpp"
+#include "Camera/JpegLuma.hpp"
+#include "Camera/ExposureSettle.hpp"
+#include "Config/Config.hpp"
+#include "Detection/FrameKernels.hpp"
+#include <freertos/semphr.h>
+#include <img_converters.h>
+#include <string.h>
 
 // Внешние объявления
 extern bool camera_initialized;
 
+// Кольцо кадров детекции
+FrameRing frameRing;
+
+// История сжатых кадров до срабатывания и её область памяти
+JpegHistory jpegHistory;
+static uint8_t *historyArena = nullptr;
+static uint32_t historyPushedAt = 0;
+
+// Статистика возраста кадров
+FrameAgeStats detectionFrameAge;
+FrameAgeStats webFrameAge;
+
+// Профили сенсора; поля экспозиции дневных профилей заполняются
+// значениями сенсора после инициализации
+static SensorProfile profiles[PROFILE_COUNT] = {
+    {"detection", {FRAMESIZE_QQVGA, PIXFORMAT_GRAYSCALE, SENSOR_KEEP, 0, GAINCEILING_2X, 0}},
+    {"photo", {FRAMESIZE_SVGA, PIXFORMAT_JPEG, SENSOR_KEEP, SENSOR_KEEP, SENSOR_KEEP, SENSOR_KEEP}},
+    {"stream", {FRAMESIZE_QQVGA, PIXFORMAT_JPEG, SENSOR_KEEP, SENSOR_KEEP, SENSOR_KEEP, SENSOR_KEEP}},
+    {"night", {FRAMESIZE_QQVGA, PIXFORMAT_GRAYSCALE, SENSOR_KEEP, 2, GAINCEILING_32X, 1}},
+};
+
+SensorCache sensorCache;
+CameraProfileStats profileStats[PROFILE_COUNT];
+
+// Режимы камеры детекции, снимков и потока
+CameraArbiter cameraArbiter;
+
+// Доступ к драйверу камеры: задача захвата, съёмка фото, веб-интерфейс
+static SemaphoreHandle_t cameraMutex = nullptr;
+
+static bool applyArbiterProfile(void *context, int profile);
+
 /**
  * @brief Инициализация камеры
  */
@@ -43,7 +82,7 @@ bool setupCamera()
     {
         config.frame_size = FRAMESIZE_SVGA;
         config.jpeg_quality = 10;
-        config.fb_count = 2;
+        config.fb_count = CAMERA_FB_COUNT;
     }
     else
     {
@@ -60,21 +99,67 @@ bool setupCamera()
         return false;
     }
 
-    // Дополнительная настройка сенсора
+    // Состояние сенсора после инициализации: профиль запишет только отличия
     sensor_t *s = esp_camera_sensor_get();
-    s->set_framesize(s, FRAMESIZE_QQVGA);
-    s->set_pixformat(s, PIXFORMAT_GRAYSCALE);
+    sensorCacheInvalidate(sensorCache);
+    sensorCacheSeed(sensorCache, SENSOR_FRAMESIZE, s->status.framesize);
+    sensorCacheSeed(sensorCache, SENSOR_PIXFORMAT, s->pixformat);
+    sensorCacheSeed(sensorCache, SENSOR_QUALITY, s->status.quality);
+    sensorCacheSeed(sensorCache, SENSOR_BRIGHTNESS, s->status.brightness);
+    sensorCacheSeed(sensorCache, SENSOR_GAINCEILING, s->status.gainceiling);
+    sensorCacheSeed(sensorCache, SENSOR_AEC2, s->status.aec2);
+
+    SensorProfile &day = profiles[PROFILE_DETECTION];
+    day.values[SENSOR_BRIGHTNESS] = s->status.brightness;
+    day.values[SENSOR_GAINCEILING] = s->status.gainceiling;
+    day.values[SENSOR_AEC2] = s->status.aec2;
+
+    if (!cameraMutex)
+        cameraMutex = xSemaphoreCreateRecursiveMutex();
 
     camera_initialized = true;
+    cameraArbiterInit(cameraArbiter, PROFILE_DETECTION, applyArbiterProfile, nullptr);
+    applyCameraProfile(PROFILE_DETECTION);
     return true;
 }
 
+/**
+ * @brief Время захвата кадра сенсором, мс по шкале millis()
+ *
+ * Драйвер ставит метку от esp_timer в момент кадровой синхронизации,
+ * как и millis().
+ */
+uint32_t frameCaptureTime(const camera_fb_t *fb)
+{
+    // tv_sec - 32-битный long: произведение считается по модулю 2^32,
+    // как и millis(), а не переполняет знаковое
+    return (uint32_t)fb->timestamp.tv_sec * 1000u + (uint32_t)(fb->timestamp.tv_usec / 1000);
+}
+
+/**
+ * @brief Захват кадра не старше maxAge
+ *
+ * Драйвер отдаёт кадры из очереди буферов, которые могли быть заполнены
+ * задолго до вызова; такие кадры возвращаются, пока очередь не опустеет.
+ * @param maxAge Допустимый возраст, мс; 0 - любой кадр
+ */
+camera_fb_t* captureFreshFrame(uint32_t maxAge)
+{
+    camera_fb_t *fb = esp_camera_fb_get();
+    for (int i = 0; fb && maxAge && i < CAMERA_FB_COUNT && millis() - frameCaptureTime(fb) > maxAge; i++)
+    {
+        esp_camera_fb_return(fb);
+        fb = esp_camera_fb_get();
+    }
+    return fb;
+}
+
 /**
  * @brief Захват кадра для детекции
  */
 camera_fb_t* captureFrame()
 {
-    return esp_camera_fb_get();
+    return captureFreshFrame(settings.max_frame_age);
 }
 
 /**
@@ -82,7 +167,133 @@ camera_fb_t* captureFrame()
  */
 camera_fb_t* captureHighResFrame()
 {
-    return esp_camera_fb_get();
+    return captureFreshFrame(settings.max_frame_age);
+}
+
+/**
+ * @brief Серия кадров с выбором самого резкого
+ *
+ * Каждый JPEG серии декодируется в уменьшенную яркость (1/8 или, при
+ * fine, 1/4 исходного размера) и оценивается дисперсией лапласиана;
+ * остальные кадры сразу возвращаются драйверу. Без PSRAM у драйвера
+ * один буфер, поэтому снимается один кадр.
+ * @param count Длина серии
+ * @param fine Оценка по 1/4 вместо 1/8: точнее, но дороже
+ */
+camera_fb_t* captureBestFrame(int count, bool fine)
+{
+    if (count <= 1 || !psramFound())
+        return captureHighResFrame();
+
+    const int divisor = fine ? 4 : 8;
+    camera_fb_t *best = nullptr;
+    float bestScore = -1;
+    uint8_t *luma = nullptr;
+    size_t lumaSize = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        camera_fb_t *fb = captureFreshFrame(settings.max_frame_age);
+        if (!fb)
+            continue;
+
+        float score = -1;
+        int width = fb->width / divisor;
+        int height = fb->height / divisor;
+        if (fb->format == PIXFORMAT_JPEG && width > 2 && height > 2)
+        {
+            if (lumaSize < (size_t)(width * height))
+            {
+                free(luma);
+                lumaSize = width * height;
+                luma = (uint8_t *)malloc(lumaSize);
+            }
+            if (luma && jpegToLuma(fb->buf, fb->len, fb->width, luma, width, height))
+                score = laplacianVariance(luma, width, height);
+        }
+
+        Serial.printf("Burst frame %d: %zu bytes, sharpness: %.0f\n", i, fb->len, score);
+
+        if (!best || score > bestScore)
+        {
+            if (best)
+                esp_camera_fb_return(best);
+            best = fb;
+            bestScore = score;
+        }
+        else
+        {
+            esp_camera_fb_return(fb);
+        }
+    }
+
+    free(luma);
+    return best;
+}
+
+/**
+ * @brief Средняя яркость кадра любого формата, -1 - кадр не прочитан
+ *
+ * JPEG декодируется с масштабом 1/8 (только DC-коэффициенты), этого
+ * достаточно для оценки экспозиции.
+ */
+static int frameBrightness(camera_fb_t *fb, uint8_t *&luma, size_t &lumaSize)
+{
+    if (fb->format == PIXFORMAT_GRAYSCALE)
+        return (int)meanLuma(fb->buf, fb->len, 4);
+    if (fb->format != PIXFORMAT_JPEG)
+        return -1;
+
+    int width = fb->width / 8;
+    int height = fb->height / 8;
+    if (width <= 0 || height <= 0)
+        return -1;
+    if (lumaSize < (size_t)(width * height))
+    {
+        free(luma);
+        lumaSize = width * height;
+        luma = (uint8_t *)malloc(lumaSize);
+    }
+    if (!luma || !jpegToLuma(fb->buf, fb->len, fb->width, luma, width, height))
+        return -1;
+    return (int)meanLuma(luma, width * height, 1);
+}
+
+/**
+ * @brief Ожидание установления экспозиции после смены режима или света
+ *
+ * Кадры берутся подряд; экспозиция считается установившейся, когда средняя
+ * яркость дважды подряд меняется между кадрами не больше чем на tolerance.
+ * Кадры, захваченные до вызова, не учитываются.
+ * @param ceiling Наибольшее время ожидания, мс
+ * @param converged true, если экспозиция установилась до ceiling
+ * @return Время ожидания, мс
+ */
+uint32_t waitForExposure(uint32_t ceiling, int tolerance, bool &converged)
+{
+    const uint32_t start = millis();
+    uint8_t *luma = nullptr;
+    size_t lumaSize = 0;
+    ExposureSettle settle;
+    converged = false;
+
+    while (millis() - start < ceiling)
+    {
+        camera_fb_t *fb = esp_camera_fb_get();
+        if (!fb)
+            break;
+
+        int brightness = (int32_t)(frameCaptureTime(fb) - start) >= 0 ? frameBrightness(fb, luma, lumaSize) : -1;
+        esp_camera_fb_return(fb);
+        if (exposureSettleUpdate(settle, brightness, tolerance))
+        {
+            converged = true;
+            break;
+        }
+    }
+
+    free(luma);
+    return millis() - start;
 }
 
 /**
@@ -94,21 +305,324 @@ void releaseFrame(camera_fb_t* fb)
 }
 
 /**
- * @brief Переключение в режим детекции
+ * @brief Профиль режима детекции по текущим настройкам
+ *
+ * В однорежимном конвейере режим детекции совпадает с режимом фото.
+ */
+CameraProfileId detectionProfile()
+{
+    if (settings.single_mode)
+        return PROFILE_PHOTO;
+    if (settings.night_mode)
+        return PROFILE_NIGHT;
+    return PROFILE_DETECTION;
+}
+
+/**
+ * @brief Переключение в режим детекции по текущим настройкам
+ *
+ * Режим детекции - базовый профиль арбитра: свободная камера переходит
+ * в него сразу, занятая - после освобождения.
  */
 void switchToDetectionMode()
 {
-    sensor_t *s = esp_camera_sensor_get();
-    s->set_framesize(s, FRAMESIZE_QQVGA);
-    s->set_pixformat(s, PIXFORMAT_GRAYSCALE);
+    cameraArbiterSetBase(cameraArbiter, detectionProfile());
+}
+
+/**
+ * @brief Запрос камеры владельцем в заданном профиле
+ *
+ * Нельзя вызывать под cameraLock(): арбитр сам захватывает камеру для
+ * переключения профиля.
+ * @param switched Если не nullptr - true, когда профиль сенсора сменился
+ * и перед съёмкой нужно дождаться экспозиции
+ * @return true - камера удерживается, нужен cameraRelease()
+ */
+bool cameraAcquire(CameraOwner owner, CameraProfileId profile, bool *switched)
+{
+    if (!camera_initialized)
+        return false;
+
+    if (!cameraArbiterAcquire(cameraArbiter, owner, profile, CAMERA_ACQUIRE_TIMEOUT, switched))
+    {
+        Serial.printf("Camera busy: %s could not get profile %s\n", cameraOwnerName(owner), cameraProfileName(profile));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Освобождение камеры владельцем
+ */
+void cameraRelease(CameraOwner owner)
+{
+    cameraArbiterRelease(cameraArbiter, owner);
+}
+
+/**
+ * @brief Ждёт ли камеру более важный владелец
+ */
+bool cameraPreempted(CameraOwner owner)
+{
+    return cameraArbiterPreempted(cameraArbiter, owner);
+}
+
+/**
+ * @brief Применение профиля по запросу арбитра
+ */
+static bool applyArbiterProfile(void *context, int profile)
+{
+    return applyCameraProfile((CameraProfileId)profile);
+}
+
+/**
+ * @brief Запись поля профиля в сенсор
+ */
+static bool writeSensorField(void *context, SensorField field, int value)
+{
+    sensor_t *s = (sensor_t *)context;
+    switch (field)
+    {
+    case SENSOR_FRAMESIZE:
+        return s->set_framesize(s, (framesize_t)value) == 0;
+    case SENSOR_PIXFORMAT:
+        return s->set_pixformat(s, (pixformat_t)value) == 0;
+    case SENSOR_QUALITY:
+        return s->set_quality(s, value) == 0;
+    case SENSOR_BRIGHTNESS:
+        return s->set_brightness(s, value) == 0;
+    case SENSOR_GAINCEILING:
+        return s->set_gainceiling(s, (gainceiling_t)value) == 0;
+    case SENSOR_AEC2:
+        return s->set_aec2(s, value) == 0;
+    default:
+        return false;
+    }
 }
 
 /**
- * @brief Переключение в режим фотографии
+ * @brief Применение профиля сенсора
+ *
+ * Записываются только поля, отличающиеся от кэша; профиль, который уже
+ * применён, не трогает сенсор. Время записи учитывается в profileStats.
+ * @return true, если сенсор в запрошенном профиле
  */
-void switchToPhotoMode()
+bool applyCameraProfile(CameraProfileId id)
 {
+    if (!camera_initialized)
+        return false;
+
+    cameraLock();
     sensor_t *s = esp_camera_sensor_get();
-    s->set_framesize(s, FRAMESIZE_SVGA);
-    s->set_pixformat(s, PIXFORMAT_JPEG);
+    uint32_t start = micros();
+    int written = sensorProfileApply(sensorCache, profiles[id], id, writeSensorField, s);
+    uint32_t elapsed = micros() - start;
+    bool applied = sensorCache.profile == id;
+    cameraUnlock();
+
+    if (written)
+    {
+        CameraProfileStats &stats = profileStats[id];
+        stats.switches++;
+        stats.lastUs = elapsed;
+        stats.maxUs = max(stats.maxUs, elapsed);
+        stats.totalUs += elapsed;
+        Serial.printf("Camera profile %s: %d writes in %u us\n", profiles[id].name, written, (unsigned)elapsed);
+    }
+    if (!applied)
+        Serial.printf("Camera profile %s: sensor write failed\n", profiles[id].name);
+    return applied;
+}
+
+/**
+ * @brief Имя профиля сенсора
+ */
+const char *cameraProfileName(int id)
+{
+    return id >= 0 && id < PROFILE_COUNT ? profiles[id].name : "unknown";
+}
+
+/**
+ * @brief Захват доступа к камере
+ *
+ * Мьютекс рекурсивный: последовательность съёмки фото держит его целиком,
+ * включая вложенные захваты кадров.
+ */
+void cameraLock()
+{
+    if (cameraMutex)
+        xSemaphoreTakeRecursive(cameraMutex, portMAX_DELAY);
+}
+
+/**
+ * @brief Освобождение доступа к камере
+ */
+void cameraUnlock()
+{
+    if (cameraMutex)
+        xSemaphoreGiveRecursive(cameraMutex);
+}
+
+/**
+ * @brief Кадр детекции и копия JPEG из кадра SVGA (однорежимный конвейер)
+ */
+static bool fillSlotFromJpeg(FrameSlot *slot, camera_fb_t *fb)
+{
+    if (slot->jpegCapacity < fb->len)
+    {
+        // Запас, чтобы не перевыделять буфер на каждом чуть большем кадре
+        size_t capacity = fb->len + fb->len / 4;
+        uint8_t *jpeg = (uint8_t *)(psramFound() ? ps_malloc(capacity) : malloc(capacity));
+        if (!jpeg)
+            return false;
+        free(slot->jpeg);
+        slot->jpeg = jpeg;
+        slot->jpegCapacity = capacity;
+    }
+
+    const size_t lumaSize = DETECTION_FRAME_WIDTH * DETECTION_FRAME_HEIGHT;
+    if (lumaSize > slot->capacity ||
+        !jpegToLuma(fb->buf, fb->len, fb->width, slot->buf, DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT))
+        return false;
+
+    memcpy(slot->jpeg, fb->buf, fb->len);
+    slot->jpegLen = fb->len;
+    return true;
+}
+
+/**
+ * @brief Добавление кадра в историю не чаще settings.history_interval
+ *
+ * JPEG режима фото кладётся как есть, полутоновый кадр детекции сжимается.
+ */
+static void pushHistoryFrame(camera_fb_t *fb, uint32_t timestamp, uint32_t sequence)
+{
+    if (!jpegHistory.limit || timestamp - historyPushedAt < (uint32_t)settings.history_interval)
+        return;
+
+    if (fb->format == PIXFORMAT_JPEG)
+    {
+        jpegHistoryPush(jpegHistory, fb->buf, fb->len, timestamp, sequence);
+    }
+    else
+    {
+        uint8_t *jpeg = nullptr;
+        size_t len = 0;
+        if (!fmt2jpg(fb->buf, fb->len, fb->width, fb->height, fb->format, HISTORY_JPEG_QUALITY, &jpeg, &len))
+            return;
+        jpegHistoryPush(jpegHistory, jpeg, len, timestamp, sequence);
+        free(jpeg);
+    }
+    historyPushedAt = timestamp;
+}
+
+/**
+ * @brief Цикл задачи захвата: непрерывно заполняет кольцо кадрами детекции
+ *
+ * В обычном режиме копируются полутоновые кадры QQVGA, в однорежимном -
+ * кадр детекции декодируется из SVGA JPEG. Кадры, не подходящие под
+ * текущий режим (камера занята фото или потоком), пропускаются.
+ */
+static void captureTask(void *parameter)
+{
+    // Номер последнего кадра, опубликованного задачей: frameRing.sequence
+    // меняется под ring.lock и без неё не читается
+    uint32_t committedSequence = 0;
+
+    for (;;)
+    {
+        cameraLock();
+        camera_fb_t *fb = esp_camera_fb_get();
+        uint32_t timestamp = fb ? frameCaptureTime(fb) : 0;
+
+        bool gray = fb && fb->format == PIXFORMAT_GRAYSCALE && !settings.single_mode;
+        bool jpeg = fb && fb->format == PIXFORMAT_JPEG && settings.single_mode;
+        if (gray || jpeg)
+        {
+            FrameSlot *slot = frameRingBeginWrite(frameRing);
+            if (slot && gray && fb->len <= slot->capacity)
+            {
+                memcpy(slot->buf, fb->buf, fb->len);
+                slot->jpegLen = 0;
+                committedSequence = frameRingCommit(frameRing, slot, fb->len, fb->width, fb->height, timestamp);
+            }
+            else if (slot && jpeg && fillSlotFromJpeg(slot, fb))
+            {
+                committedSequence = frameRingCommit(frameRing, slot, DETECTION_FRAME_WIDTH * DETECTION_FRAME_HEIGHT,
+                                                    DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT, timestamp);
+            }
+            else if (slot)
+            {
+                frameRingAbort(frameRing, slot);
+            }
+
+            pushHistoryFrame(fb, timestamp, committedSequence);
+        }
+
+        if (fb)
+            esp_camera_fb_return(fb);
+        cameraUnlock();
+
+        // Уступаем ядро задачам с тем же приоритетом
+        vTaskDelay(1);
+    }
+}
+
+/**
+ * @brief Запуск задачи захвата кадров детекции
+ */
+bool startCaptureTask()
+{
+    if (!frameRingInit(frameRing, DETECTION_FRAME_WIDTH * DETECTION_FRAME_HEIGHT))
+    {
+        Serial.println("Frame ring allocation failed");
+        return false;
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(captureTask, "capture", CAPTURE_TASK_STACK, nullptr,
+                                                 CAPTURE_TASK_PRIORITY, nullptr, CAPTURE_TASK_CORE);
+    return created == pdPASS;
+}
+
+/**
+ * @brief Ссылка на самый свежий кадр детекции
+ * @param newerThan Номер последнего обработанного кадра; 0 - любой кадр
+ * @return Кадр или nullptr, если нового кадра нет
+ */
+const FrameSlot *acquireLatestFrame(uint32_t newerThan)
+{
+    return frameRingAcquireLatest(frameRing, newerThan);
+}
+
+/**
+ * @brief Возврат ссылки на кадр детекции
+ */
+void releaseLatestFrame(const FrameSlot *frame)
+{
+    frameRingRelease(frameRing, frame);
+}
+
+/**
+ * @brief Выделение области истории кадров по текущим настройкам
+ *
+ * Область выделяется только в PSRAM; без PSRAM или при history_frames = 0
+ * история выключена. Старая область освобождается после отключения,
+ * когда задача захвата уже не может в неё писать.
+ */
+bool setupJpegHistory()
+{
+    uint8_t *arena = nullptr;
+    size_t budget = (size_t)max(0, settings.history_kb) * 1024;
+    if (settings.history_frames > 0 && budget > 0 && psramFound())
+        arena = (uint8_t *)ps_malloc(budget);
+
+    bool enabled = jpegHistoryInit(jpegHistory, arena, budget, settings.history_frames);
+    free(historyArena);
+    historyArena = arena;
+
+    if (enabled)
+        Serial.printf("JPEG history: %d frames, budget %u KB\n", jpegHistory.limit, (unsigned)(budget / 1024));
+    else
+        Serial.println("JPEG history disabled");
+    return enabled;
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+/**
+ * @file ExposureSettle.cpp
+ * @brief Реализация признака установления экспозиции
+ */
+
+#include "Camera/ExposureSettle.hpp"
+#include <stdlib.h>
+
+/**
+ * @brief Сброс перед новым ожиданием
+ */
+void exposureSettleReset(ExposureSettle &settle)
+{
+    settle.last = -1;
+    settle.stable = 0;
+}
+
+/**
+ * @brief Учёт яркости очередного кадра
+ *
+ * Изменение больше допуска начинает отсчёт заново. Непрочитанный кадр
+ * (яркость меньше 0) пропускается и отсчёт не прерывает.
+ * @return true, если экспозиция установилась
+ */
+bool exposureSettleUpdate(ExposureSettle &settle, int brightness, int tolerance)
+{
+    if (brightness < 0)
+        return false;
+
+    if (settle.last >= 0 && abs(brightness - settle.last) <= tolerance)
+        settle.stable++;
+    else
+        settle.stable = 0;
+
+    settle.last = brightness;
+    return settle.stable >= EXPOSURE_STABLE_STEPS;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/**
+ * @file FrameAge.cpp
+ * @brief Реализация гистограммы возраста кадров
+ */
+
+#include "Camera/FrameAge.hpp"
+
+const uint32_t frameAgeBounds[FRAME_AGE_BUCKETS - 1] = {25, 50, 100, 200, 500, 1000, 2000};
+
+/**
+ * @brief Учёт возраста одного кадра
+ * @param maxAllowed Допустимый возраст, мс; 0 - без ограничения
+ */
+void frameAgeRecord(FrameAgeStats &stats, uint32_t age, uint32_t maxAllowed)
+{
+    int bucket = 0;
+    while (bucket < FRAME_AGE_BUCKETS - 1 && age >= frameAgeBounds[bucket])
+        bucket++;
+
+    stats.buckets[bucket]++;
+    stats.count++;
+    stats.totalAge += age;
+    if (age > stats.maxAge)
+        stats.maxAge = age;
+    if (maxAllowed && age > maxAllowed)
+        stats.stale++;
+}
+
+/**
+ * @brief Сброс статистики
+ */
+void frameAgeReset(FrameAgeStats &stats)
+{
+    stats = FrameAgeStats();
+}
+
+/**
+ * @brief Средний возраст кадра, мс
+ */
+float frameAgeMean(const FrameAgeStats &stats)
+{
+    return stats.count ? (float)stats.totalAge / stats.count : 0.0f;
+}
\ No newline at end of file
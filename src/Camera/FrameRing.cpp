@@ -0,0 +1,143 @@
+/**
+ * @file FrameRing.cpp
+ * @brief Реализация кольца полутоновых кадров
+ */
+
+#include "Camera/FrameRing.hpp"
+#include <stdlib.h>
+
+/**
+ * @brief Выделение буферов слотов
+ *
+ * Повторный вызов с той же ёмкостью не выделяет память заново.
+ */
+bool frameRingInit(FrameRing &ring, size_t capacity)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    for (int i = 0; i < FRAME_RING_SLOTS; i++)
+    {
+        FrameSlot &slot = ring.slots[i];
+        if (slot.buf && slot.capacity == capacity)
+            continue;
+
+        free(slot.buf);
+        free(slot.jpeg);
+        slot = FrameSlot();
+        slot.buf = (uint8_t *)malloc(capacity);
+        if (!slot.buf)
+            return false;
+        slot.capacity = capacity;
+    }
+    return true;
+}
+
+/**
+ * @brief Освобождение буферов слотов
+ */
+void frameRingFree(FrameRing &ring)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    for (int i = 0; i < FRAME_RING_SLOTS; i++)
+    {
+        free(ring.slots[i].buf);
+        free(ring.slots[i].jpeg);
+        ring.slots[i] = FrameSlot();
+    }
+}
+
+/**
+ * @brief Выбор слота для записи следующего кадра
+ *
+ * Берётся самый старый слот без читателей; пока идёт запись, слот
+ * не виден frameRingAcquireLatest(), и писатель может менять его буферы
+ * (в том числе jpeg) без блокировки.
+ * @return Слот или nullptr, если все слоты заняты читателями
+ */
+FrameSlot *frameRingBeginWrite(FrameRing &ring)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    FrameSlot *oldest = nullptr;
+    for (int i = 0; i < FRAME_RING_SLOTS; i++)
+    {
+        FrameSlot &slot = ring.slots[i];
+        if (!slot.buf || slot.refs > 0 || slot.writing)
+            continue;
+        if (!oldest || slot.sequence < oldest->sequence)
+            oldest = &slot;
+    }
+
+    if (!oldest)
+    {
+        ring.framesDropped++;
+        return nullptr;
+    }
+
+    oldest->writing = true;
+    oldest->sequence = 0;
+    return oldest;
+}
+
+/**
+ * @brief Публикация записанного кадра
+ * @return Номер, присвоенный кадру
+ */
+uint32_t frameRingCommit(FrameRing &ring, FrameSlot *slot, size_t len, int width, int height, uint32_t timestamp)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    slot->len = len;
+    slot->width = width;
+    slot->height = height;
+    slot->timestamp = timestamp;
+    slot->sequence = ++ring.sequence;
+    slot->writing = false;
+    ring.framesWritten++;
+    return slot->sequence;
+}
+
+/**
+ * @brief Отказ от записи: слот остаётся пустым
+ */
+void frameRingAbort(FrameRing &ring, FrameSlot *slot)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    slot->writing = false;
+}
+
+/**
+ * @brief Ссылка на самый свежий кадр
+ * @param newerThan Номер последнего обработанного кадра; 0 - любой кадр
+ * @return Слот кадра с номером больше newerThan или nullptr
+ */
+const FrameSlot *frameRingAcquireLatest(FrameRing &ring, uint32_t newerThan)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    FrameSlot *latest = nullptr;
+    for (int i = 0; i < FRAME_RING_SLOTS; i++)
+    {
+        FrameSlot &slot = ring.slots[i];
+        if (slot.sequence > newerThan && (!latest || slot.sequence > latest->sequence))
+            latest = &slot;
+    }
+
+    if (latest)
+        latest->refs++;
+    return latest;
+}
+
+/**
+ * @brief Возврат ссылки, полученной frameRingAcquireLatest()
+ */
+void frameRingRelease(FrameRing &ring, const FrameSlot *slot)
+{
+    std::lock_guard<std::mutex> guard(ring.lock);
+
+    FrameSlot &owned = ring.slots[slot - ring.slots];
+    if (owned.refs > 0)
+        owned.refs--;
+}
\ No newline at end of file
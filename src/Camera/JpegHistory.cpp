@@ -0,0 +1,149 @@
+/**
+ * @file JpegHistory.cpp
+ * @brief Реализация истории сжатых кадров
+ */
+
+#include "Camera/JpegHistory.hpp"
+#include <string.h>
+
+namespace
+{
+    inline const JpegHistoryEntry &entryAt(const JpegHistory &history, int index)
+    {
+        return history.entries[(history.first + index) % JPEG_HISTORY_MAX_FRAMES];
+    }
+
+    /**
+     * @brief Пересекает ли какая-либо запись диапазон [start, start + len)
+     */
+    bool overlaps(const JpegHistory &history, size_t start, size_t len)
+    {
+        for (int i = 0; i < history.count; i++)
+        {
+            const JpegHistoryEntry &e = entryAt(history, i);
+            if (e.offset < start + len && e.offset + e.len > start)
+                return true;
+        }
+        return false;
+    }
+
+    inline void evictOldest(JpegHistory &history)
+    {
+        history.first = (history.first + 1) % JPEG_HISTORY_MAX_FRAMES;
+        history.count--;
+        history.evicted++;
+    }
+}
+
+/**
+ * @brief Подключение области памяти к истории
+ *
+ * Область выделяет вызывающий (на устройстве - в PSRAM) и освобождает
+ * после отключения истории (capacity = 0).
+ * @param frames Число хранимых кадров, не больше JPEG_HISTORY_MAX_FRAMES
+ */
+bool jpegHistoryInit(JpegHistory &history, uint8_t *arena, size_t capacity, int frames)
+{
+    std::lock_guard<std::mutex> guard(history.lock);
+
+    if (frames > JPEG_HISTORY_MAX_FRAMES)
+        frames = JPEG_HISTORY_MAX_FRAMES;
+
+    history.arena = arena;
+    history.capacity = arena ? capacity : 0;
+    history.limit = frames > 0 ? frames : 0;
+    history.head = 0;
+    history.first = 0;
+    history.count = 0;
+    history.frozen = false;
+    return history.capacity > 0 && history.limit > 0;
+}
+
+/**
+ * @brief Добавление кадра с вытеснением самых старых
+ *
+ * Кадр кладётся непрерывно за самым новым; если он не помещается до конца
+ * области, запись начинается с её начала. Вытесняются самые старые кадры,
+ * пока место не освободится.
+ * @return false, если кадр больше бюджета, история выключена или заморожена
+ */
+bool jpegHistoryPush(JpegHistory &history, const uint8_t *data, size_t len, uint32_t timestamp, uint32_t sequence)
+{
+    std::lock_guard<std::mutex> guard(history.lock);
+
+    if (!history.limit || !len || len > history.capacity || history.frozen)
+    {
+        history.rejected++;
+        return false;
+    }
+
+    size_t start = history.count ? history.head : 0;
+    if (start + len > history.capacity)
+        start = 0;
+
+    while (history.count > 0 && (history.count >= history.limit || overlaps(history, start, len)))
+        evictOldest(history);
+
+    memcpy(history.arena + start, data, len);
+
+    JpegHistoryEntry &entry = history.entries[(history.first + history.count) % JPEG_HISTORY_MAX_FRAMES];
+    entry.offset = start;
+    entry.len = len;
+    entry.timestamp = timestamp;
+    entry.sequence = sequence;
+    history.count++;
+    history.head = start + len;
+    history.pushed++;
+    return true;
+}
+
+/**
+ * @brief Заморозка истории на время сохранения
+ *
+ * Пока история заморожена, кадры не добавляются и не вытесняются, поэтому
+ * jpegHistoryFrame() можно вызывать без блокировки.
+ * @return Число кадров в истории
+ */
+int jpegHistoryFreeze(JpegHistory &history)
+{
+    std::lock_guard<std::mutex> guard(history.lock);
+
+    history.frozen = true;
+    return history.count;
+}
+
+/**
+ * @brief Снятие заморозки
+ */
+void jpegHistoryThaw(JpegHistory &history)
+{
+    std::lock_guard<std::mutex> guard(history.lock);
+
+    history.frozen = false;
+}
+
+/**
+ * @brief Кадр истории по номеру, 0 - самый старый
+ * @return Указатель на данные кадра в области или nullptr
+ */
+const uint8_t *jpegHistoryFrame(const JpegHistory &history, int index, JpegHistoryEntry &entry)
+{
+    if (index < 0 || index >= history.count)
+        return nullptr;
+
+    entry = entryAt(history, index);
+    return history.arena + entry.offset;
+}
+
+/**
+ * @brief Байт области, занятых кадрами
+ */
+size_t jpegHistoryUsed(JpegHistory &history)
+{
+    std::lock_guard<std::mutex> guard(history.lock);
+
+    size_t used = 0;
+    for (int i = 0; i < history.count; i++)
+        used += entryAt(history, i).len;
+    return used;
+}
\ No newline at end of file
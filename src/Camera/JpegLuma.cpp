@@ -0,0 +1,115 @@
+/**
+ * @file JpegLuma.cpp
+ * @brief Реализация уменьшенного декодирования JPEG в яркость
+ */
+
+#include "Camera/JpegLuma.hpp"
+#include <esp_jpg_decode.h>
+#include <string.h>
+
+namespace
+{
+    /**
+     * @brief Контекст декодирования
+     */
+    struct LumaDecoder
+    {
+        const uint8_t *jpeg;
+        size_t len;
+        uint8_t *out;
+        int outWidth;
+        int outHeight;
+        int decodedWidth;
+        int decodedHeight;
+    };
+
+    /**
+     * @brief Первый индекс сетки назначения, попадающий в [pos, ...)
+     *
+     * Пиксель o назначения берётся из floor(o * from / to) источника.
+     */
+    inline int firstTarget(int pos, int from, int to)
+    {
+        return (pos * to + from - 1) / from;
+    }
+
+    size_t readJpeg(void *arg, size_t index, uint8_t *buf, size_t len)
+    {
+        LumaDecoder *decoder = (LumaDecoder *)arg;
+        if (index + len > decoder->len)
+            len = decoder->len - index;
+        if (buf)
+            memcpy(buf, decoder->jpeg + index, len);
+        return len;
+    }
+
+    /**
+     * @brief Приём блока RGB888: яркость нужных пикселей блока в сетку назначения
+     *
+     * Вызов с data == nullptr сообщает размер декодированного кадра
+     * (в начале) или завершение декодирования.
+     */
+    bool writeLuma(void *arg, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t *data)
+    {
+        LumaDecoder *decoder = (LumaDecoder *)arg;
+        if (!data)
+        {
+            if (x == 0 && y == 0)
+            {
+                decoder->decodedWidth = w;
+                decoder->decodedHeight = h;
+            }
+            return true;
+        }
+
+        const int dw = decoder->decodedWidth;
+        const int dh = decoder->decodedHeight;
+        if (dw <= 0 || dh <= 0)
+            return false;
+
+        int oy0 = firstTarget(y, dh, decoder->outHeight);
+        int oy1 = firstTarget(y + h, dh, decoder->outHeight);
+        int ox0 = firstTarget(x, dw, decoder->outWidth);
+        int ox1 = firstTarget(x + w, dw, decoder->outWidth);
+        if (oy1 > decoder->outHeight) oy1 = decoder->outHeight;
+        if (ox1 > decoder->outWidth) ox1 = decoder->outWidth;
+
+        for (int oy = oy0; oy < oy1; oy++)
+        {
+            const uint8_t *row = data + (oy * dh / decoder->outHeight - y) * w * 3;
+            uint8_t *dst = decoder->out + oy * decoder->outWidth;
+            for (int ox = ox0; ox < ox1; ox++)
+            {
+                const uint8_t *rgb = row + (ox * dw / decoder->outWidth - x) * 3;
+                dst[ox] = (uint8_t)((77 * rgb[0] + 150 * rgb[1] + 29 * rgb[2]) >> 8);
+            }
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Декодирование JPEG в полутоновый кадр outWidth x outHeight
+ *
+ * Масштаб декодирования выбирается наибольшим, при котором кадр ещё
+ * не меньше назначения (SVGA 800x600 -> 1/4, 200x150), после чего
+ * выполняется выборка ближайшим соседом.
+ * @param sourceWidth Ширина исходного кадра, для выбора масштаба
+ * @return true, если кадр декодирован полностью
+ */
+bool jpegToLuma(const uint8_t *jpeg, size_t len, int sourceWidth, uint8_t *out, int outWidth, int outHeight)
+{
+    if (!jpeg || !len || !out || outWidth <= 0 || outHeight <= 0)
+        return false;
+
+    jpg_scale_t scale = JPG_SCALE_NONE;
+    if (sourceWidth / 8 >= outWidth)
+        scale = JPG_SCALE_8X;
+    else if (sourceWidth / 4 >= outWidth)
+        scale = JPG_SCALE_4X;
+    else if (sourceWidth / 2 >= outWidth)
+        scale = JPG_SCALE_2X;
+
+    LumaDecoder decoder = {jpeg, len, out, outWidth, outHeight, 0, 0};
+    return esp_jpg_decode(len, scale, readJpeg, writeLuma, &decoder) == ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * @file SensorProfile.cpp
+ * @brief Реализация применения профилей сенсора
+ */
+
+#include "Camera/SensorProfile.hpp"
+
+/**
+ * @brief Применение профиля с пропуском уже установленных значений
+ *
+ * Поле со значением SENSOR_KEEP не трогается. Неудачная запись
+ * сбрасывает знание о поле, чтобы следующее применение повторило её.
+ * @param profileId Номер профиля для пропуска повторного применения
+ * @return Число записанных полей
+ */
+int sensorProfileApply(SensorCache &cache, const SensorProfile &profile, int profileId,
+                       SensorWriter writer, void *context)
+{
+    if (cache.profile == profileId)
+    {
+        cache.skipped++;
+        return 0;
+    }
+
+    int written = 0;
+    bool complete = true;
+    for (int i = 0; i < SENSOR_FIELD_COUNT; i++)
+    {
+        int value = profile.values[i];
+        if (value == SENSOR_KEEP)
+            continue;
+
+        if (cache.known[i] && cache.values[i] == value)
+        {
+            cache.elided++;
+            continue;
+        }
+
+        if (writer(context, (SensorField)i, value))
+        {
+            cache.values[i] = value;
+            cache.known[i] = true;
+            cache.writes++;
+            written++;
+        }
+        else
+        {
+            cache.known[i] = false;
+            complete = false;
+        }
+    }
+
+    cache.profile = complete ? profileId : -1;
+    if (written)
+        cache.switches++;
+    return written;
+}
+
+/**
+ * @brief Запись в кэш значения, установленного в обход профилей
+ *
+ * Применённый профиль становится неизвестным: поле могло измениться.
+ */
+void sensorCacheSeed(SensorCache &cache, SensorField field, int value)
+{
+    cache.values[field] = value;
+    cache.known[field] = true;
+    cache.profile = -1;
+}
+
+/**
+ * @brief Сброс кэша: следующее применение запишет все поля профиля
+ */
+void sensorCacheInvalidate(SensorCache &cache)
+{
+    for (int i = 0; i < SENSOR_FIELD_COUNT; i++)
+        cache.known[i] = false;
+    cache.profile = -1;
+}
\ No newline at end of file
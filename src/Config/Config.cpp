@@ -4,6 +4,8 @@
  */
 
 #include "Config/Config.hpp"
+#include "Detection/FrameKernels.hpp"
+#include "Detection/BackgroundModel.hpp"
 #include <SD_MMC.h>
 #include <ArduinoJson.h>
 
@@ -41,12 +43,55 @@ void loadSettings()
         settings.area = doc["area"] | 500;
         settings.dark_min = doc["dark_min"] | 0.2;
         settings.dark_max = doc["dark_max"] | 0.8;
-        settings.texture = doc["texture"] | 500.0;
+        // Ключ "texture" прежних версий хранил неиспользуемые 500 и не читается
+        settings.texture = doc["texture_min"] | 0.0;
+        settings.integral_mode = doc["integral_mode"] | 0;
+        settings.background = doc["background"] | false;
+        settings.bg_shift = constrain((int)(doc["bg_shift"] | 4), BG_SHIFT_MIN, BG_SHIFT_MAX);
+        settings.fg_threshold = doc["fg_threshold"] | 25;
+        settings.motion_gate = doc["motion_gate"] | 0;
+        settings.blob = doc["blob"] | false;
+        settings.stride = doc["stride"] | 1;
+        settings.confirm_n = doc["confirm_n"] | 2;
+        settings.confirm_m = doc["confirm_m"] | 3;
+        settings.single_mode = doc["single_mode"] | false;
+        settings.history_frames = doc["history_frames"] | 8;
+        settings.history_kb = doc["history_kb"] | 512;
+        settings.history_interval = doc["history_interval"] | 250;
+        settings.burst_frames = doc["burst_frames"] | 1;
+        settings.burst_fine = doc["burst_fine"] | false;
+        settings.max_frame_age = doc["max_frame_age"] | 200;
+        settings.settle_max = doc["settle_max"] | 1500;
+        settings.settle_tolerance = doc["settle_tolerance"] | 2;
+        settings.night_mode = doc["night_mode"] | false;
+        settings.storage_policy = doc["storage_policy"] | 0;
         settings.max_files = doc["max_files"] | 250;
+        settings.min_free_percent = doc["min_free_percent"] | 0;
         settings.roi_width = doc["roi_width"] | 80;
         settings.roi_height = doc["roi_height"] | 60;
         settings.roi_x = doc["roi_x"] | 40;
         settings.roi_y = doc["roi_y"] | 30;
+
+        JsonArray zones = doc["zones"];
+        settings.zone_count = 1;
+        if (!zones.isNull())
+        {
+            settings.zone_count = 0;
+            for (JsonObject zone : zones)
+            {
+                if (settings.zone_count >= MAX_DETECTION_ZONES)
+                    break;
+
+                DetectionZone &z = settings.zones[settings.zone_count++];
+                z.x = zone["x"] | 0;
+                z.y = zone["y"] | 0;
+                z.width = zone["width"] | 80;
+                z.height = zone["height"] | 60;
+                z.threshold = zone["threshold"] | settings.threshold;
+                z.area = zone["area"] | settings.area;
+            }
+            settings.zone_count = max(1, settings.zone_count);
+        }
         settings.ap_ssid = doc["ap_ssid"] | "CarDetector";
         settings.ap_password = doc["ap_password"] | "12345678";
 
@@ -80,12 +125,46 @@ void saveSettings()
     doc["area"] = settings.area;
     doc["dark_min"] = settings.dark_min;
     doc["dark_max"] = settings.dark_max;
-    doc["texture"] = settings.texture;
+    doc["texture_min"] = settings.texture;
+    doc["integral_mode"] = settings.integral_mode;
+    doc["background"] = settings.background;
+    doc["bg_shift"] = settings.bg_shift;
+    doc["fg_threshold"] = settings.fg_threshold;
+    doc["motion_gate"] = settings.motion_gate;
+    doc["blob"] = settings.blob;
+    doc["stride"] = settings.stride;
+    doc["confirm_n"] = settings.confirm_n;
+    doc["confirm_m"] = settings.confirm_m;
+    doc["single_mode"] = settings.single_mode;
+    doc["history_frames"] = settings.history_frames;
+    doc["history_kb"] = settings.history_kb;
+    doc["history_interval"] = settings.history_interval;
+    doc["burst_frames"] = settings.burst_frames;
+    doc["burst_fine"] = settings.burst_fine;
+    doc["max_frame_age"] = settings.max_frame_age;
+    doc["settle_max"] = settings.settle_max;
+    doc["settle_tolerance"] = settings.settle_tolerance;
+    doc["night_mode"] = settings.night_mode;
+    doc["storage_policy"] = settings.storage_policy;
     doc["max_files"] = settings.max_files;
+    doc["min_free_percent"] = settings.min_free_percent;
     doc["roi_width"] = settings.roi_width;
     doc["roi_height"] = settings.roi_height;
     doc["roi_x"] = settings.roi_x;
     doc["roi_y"] = settings.roi_y;
+
+    JsonArray zones = doc.createNestedArray("zones");
+    for (int i = 0; i < settings.zone_count; i++)
+    {
+        const DetectionZone &z = settings.zones[i];
+        JsonObject zone = zones.createNestedObject();
+        zone["x"] = z.x;
+        zone["y"] = z.y;
+        zone["width"] = z.width;
+        zone["height"] = z.height;
+        zone["threshold"] = z.threshold;
+        zone["area"] = z.area;
+    }
     doc["ap_ssid"] = settings.ap_ssid;
     doc["ap_password"] = settings.ap_password;
 
@@ -101,19 +180,40 @@ void saveSettings()
 }
 
 /**
- * @brief Обновление координат ROI
+ * @brief Обновление координат ROI и зон детекции
  */
 void updateROICoordinates()
 {
     if (settings.roi_x == 0 && settings.roi_y == 0)
     {
-        settings.roi_x = (160 - settings.roi_width) / 2;
-        settings.roi_y = (120 - settings.roi_height) / 2;
+        settings.roi_x = (DETECTION_FRAME_WIDTH - settings.roi_width) / 2;
+        settings.roi_y = (DETECTION_FRAME_HEIGHT - settings.roi_height) / 2;
     }
 
-    settings.roi_x = max(0, min(settings.roi_x, 160 - settings.roi_width));
-    settings.roi_y = max(0, min(settings.roi_y, 120 - settings.roi_height));
+    settings.roi_x = max(0, min(settings.roi_x, DETECTION_FRAME_WIDTH - settings.roi_width));
+    settings.roi_y = max(0, min(settings.roi_y, DETECTION_FRAME_HEIGHT - settings.roi_height));
 
     Serial.printf("ROI configured: x=%d, y=%d, width=%d, height=%d\n", 
                   settings.roi_x, settings.roi_y, settings.roi_width, settings.roi_height);
+
+    DetectionZone &primary = settings.zones[0];
+    primary.x = settings.roi_x;
+    primary.y = settings.roi_y;
+    primary.width = settings.roi_width;
+    primary.height = settings.roi_height;
+    primary.threshold = settings.threshold;
+    primary.area = settings.area;
+
+    settings.zone_count = max(1, min(settings.zone_count, MAX_DETECTION_ZONES));
+    for (int i = 1; i < settings.zone_count; i++)
+    {
+        DetectionZone &z = settings.zones[i];
+        z.width = max(1, min(z.width, DETECTION_FRAME_WIDTH));
+        z.height = max(1, min(z.height, DETECTION_FRAME_HEIGHT));
+        z.x = max(0, min(z.x, DETECTION_FRAME_WIDTH - z.width));
+        z.y = max(0, min(z.y, DETECTION_FRAME_HEIGHT - z.height));
+
+        Serial.printf("Zone %d configured: x=%d, y=%d, width=%d, height=%d\n",
+                      i, z.x, z.y, z.width, z.height);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+/**
+ * @file BackgroundModel.cpp
+ * @brief Реализация модели фона
+ */
+
+#include "Detection/BackgroundModel.hpp"
+#include <stdlib.h>
+
+/**
+ * @brief Выделение буфера модели
+ *
+ * При изменении размеров кадра модель создаётся заново и будет засеяна
+ * следующим кадром.
+ */
+bool backgroundModelInit(BackgroundModel &model, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    if (model.mean && model.width == width && model.height == height)
+        return true;
+
+    backgroundModelFree(model);
+    model.mean = (uint16_t *)malloc((size_t)width * height * sizeof(uint16_t));
+    if (!model.mean)
+        return false;
+
+    model.width = width;
+    model.height = height;
+    return true;
+}
+
+/**
+ * @brief Освобождение буфера модели
+ */
+void backgroundModelFree(BackgroundModel &model)
+{
+    free(model.mean);
+    model.mean = nullptr;
+    model.width = 0;
+    model.height = 0;
+    model.seeded = false;
+}
+
+/**
+ * @brief Инициализация фона текущим кадром
+ */
+void backgroundModelSeed(BackgroundModel &model, const uint8_t *image)
+{
+    const int pixels = model.width * model.height;
+    for (int i = 0; i < pixels; i++)
+    {
+        model.mean[i] = (uint16_t)(image[i] << 8);
+    }
+    model.seeded = true;
+}
+
+/**
+ * @brief Подсчёт пикселей переднего плана области с обновлением фона
+ *
+ * Пиксель относится к переднему плану, если отличается от фона больше
+ * чем на foregroundThreshold. При update фон области сдвигается к кадру
+ * с коэффициентом 2^-alphaShift в том же проходе, после сравнения.
+ * @return Число пикселей переднего плана
+ */
+uint32_t backgroundModelProcess(BackgroundModel &model, const uint8_t *image, const PixelRect &region,
+                                int foregroundThreshold, int alphaShift, bool update)
+{
+    uint32_t count = 0;
+
+    for (int y = region.y; y < region.y + region.height; y++)
+    {
+        const uint8_t *row = image + y * model.width + region.x;
+        uint16_t *mean = model.mean + y * model.width + region.x;
+
+        for (int x = 0; x < region.width; x++)
+        {
+            int diff = row[x] - (mean[x] >> 8);
+            count += (diff > foregroundThreshold) | (diff < -foregroundThreshold);
+
+            if (update)
+            {
+                int delta = ((int)row[x] << 8) - mean[x];
+                mean[x] = (uint16_t)(mean[x] + (delta >> alphaShift));
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Маска переднего плана сегмента строки (1 - передний план)
+ */
+void backgroundModelMaskRow(const BackgroundModel &model, const uint8_t *image, int y, int x0, int length,
+                            int foregroundThreshold, uint8_t *mask)
+{
+    const uint8_t *row = image + y * model.width + x0;
+    const uint16_t *mean = model.mean + y * model.width + x0;
+
+    for (int x = 0; x < length; x++)
+    {
+        int diff = row[x] - (mean[x] >> 8);
+        mask[x] = (diff > foregroundThreshold) | (diff < -foregroundThreshold);
+    }
+}
\ No newline at end of file
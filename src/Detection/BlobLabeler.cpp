@@ -0,0 +1,270 @@
+/**
+ * @file BlobLabeler.cpp
+ * @brief Реализация выделения связных областей
+ */
+
+#include "Detection/BlobLabeler.hpp"
+#include <stdlib.h>
+
+namespace
+{
+    /**
+     * @brief Поиск корня множества с сокращением пути вдвое
+     */
+    inline int findRoot(uint16_t *parent, int i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+
+    /**
+     * @brief Объединение множеств, корнем становится меньший индекс
+     */
+    inline void unite(uint16_t *parent, int a, int b)
+    {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a < b)
+            parent[b] = (uint16_t)a;
+        else if (b < a)
+            parent[a] = (uint16_t)b;
+    }
+
+    /**
+     * @brief Переход к новой строке: серии прошлой строки становятся соседями
+     */
+    inline void beginRow(BlobLabeler &labeler, int y)
+    {
+        if (y == labeler.lastY)
+            return;
+
+        if (y == labeler.lastY + 1)
+        {
+            labeler.prevStart = labeler.prevEnd;
+            labeler.prevEnd = labeler.runCount;
+        }
+        else
+        {
+            labeler.prevStart = labeler.runCount;
+            labeler.prevEnd = labeler.runCount;
+        }
+        labeler.lastY = y;
+    }
+
+    /**
+     * @brief Добавление серии [x0, x1] строки y
+     */
+    void addRun(BlobLabeler &labeler, int y, int x0, int x1)
+    {
+        labeler.pixels += x1 - x0 + 1;
+        if (labeler.runCount >= labeler.capacity)
+        {
+            labeler.overflow = true;
+            return;
+        }
+
+        const int index = labeler.runCount++;
+        labeler.parent[index] = (uint16_t)index;
+        labeler.start[index] = (uint16_t)x0;
+        labeler.end[index] = (uint16_t)x1;
+        labeler.row[index] = (uint16_t)y;
+
+        // Серии строки упорядочены по x, поэтому достаточно сдвигать начало
+        // окна предыдущей строки
+        while (labeler.prevStart < labeler.prevEnd && labeler.end[labeler.prevStart] + 1 < x0)
+            labeler.prevStart++;
+
+        for (int j = labeler.prevStart; j < labeler.prevEnd && labeler.start[j] <= x1 + 1; j++)
+        {
+            unite(labeler.parent, index, j);
+        }
+    }
+}
+
+/**
+ * @brief Наибольшее число серий в области width x height
+ *
+ * Серии строки разделены хотя бы одним пикселем фона, поэтому в строке
+ * их не больше (width + 1) / 2 (чередующиеся пиксели).
+ */
+int blobRunCapacity(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return 0;
+
+    long runs = (long)height * ((width + 1) / 2);
+    return runs > BLOB_MAX_RUNS ? BLOB_MAX_RUNS : (int)runs;
+}
+
+/**
+ * @brief Выделение таблицы серий не меньше capacity
+ *
+ * Таблица только растёт; при нехватке памяти прежняя таблица
+ * сохраняется, а лишние серии отмечаются флагом overflow.
+ */
+bool blobLabelerInit(BlobLabeler &labeler, int capacity)
+{
+    if (capacity > BLOB_MAX_RUNS)
+        capacity = BLOB_MAX_RUNS;
+    if (capacity <= labeler.capacity)
+        return true;
+
+    uint16_t *runs = (uint16_t *)malloc((size_t)capacity * 4 * sizeof(uint16_t));
+    uint32_t *area = (uint32_t *)malloc((size_t)capacity * sizeof(uint32_t));
+    if (!runs || !area)
+    {
+        free(runs);
+        free(area);
+        return false;
+    }
+
+    blobLabelerFree(labeler);
+    labeler.parent = runs;
+    labeler.start = runs + capacity;
+    labeler.end = runs + 2 * capacity;
+    labeler.row = runs + 3 * capacity;
+    labeler.area = area;
+    labeler.capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Освобождение таблицы серий
+ */
+void blobLabelerFree(BlobLabeler &labeler)
+{
+    free(labeler.parent);
+    free(labeler.area);
+    labeler.parent = nullptr;
+    labeler.start = nullptr;
+    labeler.end = nullptr;
+    labeler.row = nullptr;
+    labeler.area = nullptr;
+    labeler.capacity = 0;
+    blobLabelerReset(labeler);
+}
+
+/**
+ * @brief Подготовка к разметке новой области
+ */
+void blobLabelerReset(BlobLabeler &labeler)
+{
+    labeler.runCount = 0;
+    labeler.prevStart = 0;
+    labeler.prevEnd = 0;
+    labeler.lastY = -2;
+    labeler.pixels = 0;
+    labeler.overflow = false;
+}
+
+/**
+ * @brief Добавление строки кадра: маской служат пиксели темнее порога
+ */
+void blobAddDarkRow(BlobLabeler &labeler, const uint8_t *row, int x0, int length, int y, int threshold)
+{
+    beginRow(labeler, y);
+
+    int x = 0;
+    while (x < length)
+    {
+        while (x < length && row[x] >= threshold)
+            x++;
+        if (x == length)
+            break;
+
+        int runStart = x;
+        while (x < length && row[x] < threshold)
+            x++;
+        addRun(labeler, y, x0 + runStart, x0 + x - 1);
+    }
+}
+
+/**
+ * @brief Добавление строки готовой маски (ненулевые байты - передний план)
+ */
+void blobAddMaskRow(BlobLabeler &labeler, const uint8_t *mask, int x0, int length, int y)
+{
+    beginRow(labeler, y);
+
+    int x = 0;
+    while (x < length)
+    {
+        while (x < length && !mask[x])
+            x++;
+        if (x == length)
+            break;
+
+        int runStart = x;
+        while (x < length && mask[x])
+            x++;
+        addRun(labeler, y, x0 + runStart, x0 + x - 1);
+    }
+}
+
+/**
+ * @brief Завершение разметки и поиск наибольшей области
+ *
+ * Площади накапливаются по корням множеств, затем второй проход по
+ * сериям наибольшей области даёт её рамку и центр масс.
+ * @return false, если маска пуста
+ */
+bool blobLargest(BlobLabeler &labeler, BlobInfo &blob)
+{
+    blob = BlobInfo();
+    const int count = labeler.runCount;
+    if (count == 0)
+        return false;
+
+    // Сжатие путей: после него parent[i] указывает прямо на корень,
+    // а корни идут раньше своих серий
+    uint32_t *area = labeler.area;
+    for (int i = 0; i < count; i++)
+    {
+        labeler.parent[i] = labeler.parent[labeler.parent[i]];
+        area[i] = 0;
+    }
+
+    int best = 0;
+    for (int i = 0; i < count; i++)
+    {
+        int root = labeler.parent[i];
+        area[root] += labeler.end[i] - labeler.start[i] + 1;
+        if (area[root] > area[best])
+            best = root;
+    }
+
+    uint64_t sumX = 0;
+    uint64_t sumY = 0;
+    blob.area = area[best];
+    blob.minX = labeler.start[best];
+    blob.maxX = labeler.end[best];
+    blob.minY = labeler.row[best];
+    blob.maxY = labeler.row[best];
+
+    for (int i = best; i < count; i++)
+    {
+        if (labeler.parent[i] != best)
+            continue;
+
+        int x0 = labeler.start[i];
+        int x1 = labeler.end[i];
+        int y = labeler.row[i];
+        uint32_t length = x1 - x0 + 1;
+
+        if (x0 < blob.minX) blob.minX = x0;
+        if (x1 > blob.maxX) blob.maxX = x1;
+        if (y < blob.minY) blob.minY = y;
+        if (y > blob.maxY) blob.maxY = y;
+
+        sumX += (uint64_t)(x0 + x1) * length / 2;
+        sumY += (uint64_t)y * length;
+    }
+
+    blob.centroidX = (float)sumX / blob.area;
+    blob.centroidY = (float)sumY / blob.area;
+    return true;
+}
\ No newline at end of file
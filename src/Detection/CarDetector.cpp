@@ -4,10 +4,14 @@
  */
 
 #include "Detection/CarDetector.hpp"
+#include "Detection/FrameAnalyzer.hpp"
 #include "Config/Config.hpp"
 #include "Camera/CameraController.hpp"
 #include "Storage/SDCardManager.hpp"
 #include "Storage/PreferencesManager.hpp"
+#include "Storage/StorageWriter.hpp"
+#include "Storage/EventLog.hpp"
+#include "Storage/PhotoArchive.hpp"
 #include "Utils/FlashController.hpp"
 #include <ArduinoJson.h>
 
@@ -20,108 +24,300 @@ extern int photoNumber;
 extern bool sd_initialized;
 extern Settings settings;
 
+// Номер последнего проанализированного кадра кольца
+static uint32_t analyzedSequence = 0;
+
+// Время захвата кадра, на котором подтверждено прибытие
+static uint32_t triggerTimestamp = 0;
+
+// Время установления экспозиции перед последним фото, мс
+static uint32_t photoSettleMs = 0;
+
+static void saveZonePhotos(uint32_t zoneMask, camera_fb_t *fb);
+
+/**
+ * @brief Перенос результата анализа кадра в состояние детектора
+ */
+static void publishZones(uint32_t triggeredZones, int distance)
+{
+    if (triggeredZones)
+        resDistance = distance;
+
+    // Автомобиль считается стоящим, пока занята хотя бы одна зона
+    car_detected = zonesOccupied();
+}
+
 /**
  * @brief Основная функция детектирования автомобиля
+ *
+ * Кадр, снятый до выключения вспышки, не анализируется: мигание при
+ * стоящем автомобиле засвечивало бы зоны.
+ * @return false - нового кадра без вспышки ещё нет, вызов нужно повторить
  */
-void detectCar()
+bool detectCar()
 {
-    camera_fb_t *fb = captureFrame();
+    // Самый свежий кадр задачи захвата, ещё не проходивший анализ
+    const FrameSlot *frame = acquireLatestFrame(analyzedSequence);
+    if (!frame)
+        return false;
 
-    if (fb)
+    if ((int32_t)(frame->timestamp - flashOffTime()) <= 0)
     {
-        int darkPixels = 0;
-        int totalPixels = 0;
-        float darkRatio = 0;
+        analyzedSequence = frame->sequence;
+        releaseLatestFrame(frame);
+        return false;
+    }
 
-        if (fb->format == PIXFORMAT_GRAYSCALE)
-        {
-            analyzeFrame(fb, darkPixels, totalPixels, darkRatio);
-        }
+    if (settings.max_frame_age > 0 && millis() - frame->timestamp > (uint32_t)settings.max_frame_age)
+    {
+        // Задача захвата стояла (фото, поток): решение по старому кадру не принимается
+        frameAgeRecord(detectionFrameAge, millis() - frame->timestamp, settings.max_frame_age);
+        Serial.printf("Stale detection frame skipped: %u ms\n", (unsigned)(millis() - frame->timestamp));
+        analyzedSequence = frame->sequence;
+        releaseLatestFrame(frame);
+        return true;
+    }
+
+    bool analyzed = false;
+    analyzedSequence = frame->sequence;
+
+    const int distance = lastDistance;
+    uint32_t triggeredZones = detectInFrame(frame->buf, frame->width, frame->height, distance, analyzed);
+    if (analyzed)
+    {
+        publishZones(triggeredZones, distance);
+        frameAgeRecord(detectionFrameAge, millis() - frame->timestamp, settings.max_frame_age);
+    }
+
+    if (triggeredZones)
+        triggerTimestamp = frame->timestamp;
+
+    // Однорежимный конвейер: фото - JPEG этого же кадра, без переключения режимов;
+    // при серии фото выбирается из кадров после срабатывания
+    if (triggeredZones && frame->jpegLen > 0 && settings.burst_frames <= 1)
+    {
+        camera_fb_t jpeg = {};
+        jpeg.buf = frame->jpeg;
+        jpeg.len = frame->jpegLen;
+        jpeg.format = PIXFORMAT_JPEG;
+        photoSettleMs = 0;
+        saveZonePhotos(triggeredZones, &jpeg);
+        timeInterval = millis();
+        triggeredZones = 0;
+    }
 
-        releaseFrame(fb);
+    releaseLatestFrame(frame);
 
-        if (car_detected)
+    if (triggeredZones)
+    {
+        takeHighQualityPhoto(triggeredZones);
+
+        // Кадры, снятые до съёмки фото (в том числе со вспышкой), пропускаются
+        const FrameSlot *stale = acquireLatestFrame(analyzedSequence);
+        if (stale)
         {
-            takeHighQualityPhoto(darkPixels, totalPixels, darkRatio);
+            analyzedSequence = stale->sequence;
+            releaseLatestFrame(stale);
         }
     }
-    else
+
+    return true;
+}
+
+/**
+ * @brief Анализ полутонового кадра камеры
+ * @return Битовая маска зон, в которых прибытие подтверждено на этом кадре
+ */
+uint32_t analyzeFrame(camera_fb_t *fb)
+{
+    const int distance = lastDistance;
+    uint32_t triggeredZones = analyzeImage(fb->buf, fb->width, fb->height, distance);
+    publishZones(triggeredZones, distance);
+    return triggeredZones;
+}
+
+/**
+ * @brief Кадры истории до срабатывания в событие записи
+ *
+ * Файлы именуются по номеру события: car_NNNNN_pre<k>.jpg в каталоге
+ * архива. Кадры копируются в событие, поэтому история заморожена
+ * недолго; в метаданные их вносит задача записи после записи на карту.
+ */
+static void saveHistoryFrames(uint32_t id, StorageEvent *event)
+{
+    int count = jpegHistoryFreeze(jpegHistory);
+    for (int k = 0; k < count; k++)
     {
-        Serial.println("Camera capture failed");
+        JpegHistoryEntry entry;
+        const uint8_t *data = jpegHistoryFrame(jpegHistory, k, entry);
+        int32_t offset = (int32_t)(entry.timestamp - triggerTimestamp);
+
+        // Кадр срабатывания и более поздние сохраняются самой фотографией
+        if (!data || offset >= 0)
+            continue;
+
+        StorageBlob *blob = storageBlobCreate(data, entry.len);
+        if (!blob)
+            continue;
+
+        StorageFrame frame;
+        frame.path = photoPrePath(id, event->frames.size());
+        frame.blob = blob;
+        frame.offset = offset;
+        event->frames.push_back(frame);
     }
+    jpegHistoryThaw(jpegHistory);
 }
 
 /**
- * @brief Анализ кадра для детектирования
+ * @brief Сохранение фотографии и метаданных для каждой сработавшей зоны
+ *
+ * Кадры истории до срабатывания сохраняются один раз под номером первой
+ * фотографии события, метаданные каждой зоны ссылаются на них и
+ * записываются в журнал событий под номером фотографии. Событие целиком
+ * ставится в очередь одной записью; кадр копируется один раз для всех
+ * зон, и буфер камеры можно вернуть сразу после вызова.
  */
-int analyzeFrame(camera_fb_t *fb, int &darkPixels, int &totalPixels, float &darkRatio)
+static void saveZonePhotos(uint32_t zoneMask, camera_fb_t *fb)
 {
-    uint8_t *grayImage = fb->buf;
-
-    int max_y = min(settings.roi_y + settings.roi_height, (int)fb->height);
-    int max_x = min(settings.roi_x + settings.roi_width, (int)fb->width);
-    int roi_w = max(0, max_x - settings.roi_x);
-    int roi_h = max(0, max_y - settings.roi_y);
-    totalPixels = roi_w * roi_h;
+    if (!sd_initialized)
+        return;
 
-    for (int y = settings.roi_y; y < max_y; y++)
+    StorageEvent *event = new StorageEvent;
+    event->photo = storageBlobCreate(fb->buf, fb->len);
+    if (!event->photo)
     {
-        for (int x = settings.roi_x; x < max_x; x++)
-        {
-            if (x >= fb->width || y >= fb->height) continue;
-            
-            int idx = y * fb->width + x;
-            if (grayImage[idx] < settings.threshold)
-            {
-                darkPixels++;
-            }
-        }
+        Serial.println("No memory to queue photo");
+        storageEventFree(event);
+        storageStats.dropped++;
+        return;
     }
 
-    darkRatio = totalPixels > 0 ? ((float)darkPixels / totalPixels) : 0.0;
-
-    if (darkRatio > settings.dark_min && darkRatio < settings.dark_max)
+    // Номера занимаются при постановке события в очередь, по одному на зону
+    uint32_t id = photoNumber;
+    saveHistoryFrames(id, event);
+    for (int i = 0; i < settings.zone_count; i++)
     {
-        if (darkPixels > settings.area && 
-            lastDistance != 0 && 
-            settings.distance > lastDistance)
+        if (!(zoneMask & (1u << i)))
+            continue;
+
+        const ZoneState &state = zoneStates[i];
+        const DetectionZone &zone = settings.zones[i];
+
+        String num = (String)id;
+        while (num.length() < 5)
+            num = "0" + num;
+
+        String path = photoPath(id);
+
+        DynamicJsonDocument doc(1024);
+        doc["id"] = num;
+        doc["image"] = path;
+        doc["zone"] = i;
+        JsonArray rect = doc.createNestedArray("zoneRect");
+        rect.add(zone.x);
+        rect.add(zone.y);
+        rect.add(zone.width);
+        rect.add(zone.height);
+        doc["totalPixels"] = state.totalPixels;
+        doc["darkPixels"] = state.darkPixels;
+        doc["whitePixels"] = state.totalPixels - state.darkPixels;
+        doc["darkRatio"] = state.darkRatio;
+        doc["texture"] = state.texture;
+        doc["threshold"] = state.threshold;
+        if (state.hasBlob)
         {
-            resDistance = lastDistance;
-            car_detected = true;
-            Serial.printf("Car detected! Dark pixels: %d, ratio: %.2f, distance: %d\n", 
-                         darkPixels, darkRatio, lastDistance);
+            JsonObject blob = doc.createNestedObject("blob");
+            blob["area"] = state.blob.area;
+            JsonArray bbox = blob.createNestedArray("bbox");
+            bbox.add(state.blob.minX);
+            bbox.add(state.blob.minY);
+            bbox.add(state.blob.maxX - state.blob.minX + 1);
+            bbox.add(state.blob.maxY - state.blob.minY + 1);
+            JsonArray centroid = blob.createNestedArray("centroid");
+            centroid.add(state.blob.centroidX);
+            centroid.add(state.blob.centroidY);
         }
-        else
+        if (state.hasHistogram)
         {
-            Serial.printf("Car not detected! Dark pixels: %d, ratio: %.2f, distance: %d\n", 
-                         darkPixels, darkRatio, lastDistance);
+            JsonObject luma = doc.createNestedObject("luma");
+            luma["mean"] = state.histogram.mean;
+            luma["variance"] = state.histogram.variance;
+            luma["p10"] = state.histogram.p10;
+            luma["p50"] = state.histogram.p50;
+            luma["p90"] = state.histogram.p90;
         }
+        doc["distance"] = lastDistance;
+        doc["settle_ms"] = photoSettleMs;
+        doc["uptime_ms"] = triggerTimestamp;
+
+        StoragePhoto photo;
+        photo.path = path;
+        serializeJson(doc, photo.metadata);
+        photo.entry.id = id;
+        photo.entry.uptime = triggerTimestamp;
+        photo.entry.distance = max(0, lastDistance);
+        photo.entry.darkPermille = photoIndexPermille(state.darkRatio);
+        photo.entry.zone = i;
+        event->photos.push_back(photo);
+        id++;
     }
-    else
+
+    if (event->photos.empty())
     {
-        Serial.printf("Car not detected 2! Dark pixels: %d, ratio: %.2f, distance: %d\n", 
-                     darkPixels, darkRatio, lastDistance);
+        storageEventFree(event);
+        return;
     }
 
-    return darkPixels;
+    // Результат записи учитывается в storageStats
+    int photos = event->photos.size();
+    int frames = event->frames.size();
+    if (storageEnqueue(event))
+    {
+        Serial.printf("Event queued: %d photos, %d pre-trigger frames\n", photos, frames);
+        for (int i = 0; i < photos; i++)
+            savePreferences();
+    }
+    else
+    {
+        Serial.println("Failed to queue photo");
+    }
 }
 
 /**
  * @brief Создание высококачественной фотографии
+ *
+ * Для каждой сработавшей зоны сохраняется отдельная фотография и файл
+ * метаданных.
  */
-void takeHighQualityPhoto(int darkPixels, int totalPixels, float darkRatio)
+void takeHighQualityPhoto(uint32_t zoneMask)
 {
     Serial.println("Taking high quality photo...");
 
-    onFlash();
-    vTaskDelay(500 / portTICK_PERIOD_MS);
-    offFlash();
-    vTaskDelay(200 / portTICK_PERIOD_MS);
+    // Режим фото запрашивается у арбитра до захвата камеры; задача захвата
+    // пропускает кадры, пока камера не вернётся в режим детекции. Детектор
+    // важнее остальных владельцев: пока он ждёт, новые запросы снимков
+    // не удовлетворяются, а поток уступает камеру между кадрами
+    photoSettleMs = 0;
+    bool switched = false;
+    if (!cameraAcquire(OWNER_DETECTOR, PROFILE_PHOTO, &switched))
+    {
+        Serial.println("Photo not taken: camera unavailable");
+        timeInterval = millis();
+        return;
+    }
+    cameraLock();
 
-    switchToPhotoMode();
-    vTaskDelay(1500 / portTICK_PERIOD_MS);
+    // Вместо фиксированных пауз - ожидание установления экспозиции;
+    // в однорежимном конвейере камера уже в режиме фото
+    if (switched)
+    {
+        bool converged;
+        photoSettleMs = waitForExposure(settings.settle_max, settings.settle_tolerance, converged);
+        Serial.printf("Photo mode settled in %u ms%s\n", (unsigned)photoSettleMs, converged ? "" : " (ceiling)");
+    }
 
-    camera_fb_t *hi_res_fb = captureHighResFrame();
+    camera_fb_t *hi_res_fb = captureBestFrame(settings.burst_frames, settings.burst_fine);
 
     if (hi_res_fb)
     {
@@ -130,34 +326,7 @@ void takeHighQualityPhoto(int darkPixels, int totalPixels, float darkRatio)
 
         if (hi_res_fb->format == PIXFORMAT_JPEG && hi_res_fb->len > 0)
         {
-            if (sd_initialized)
-            {
-                String num = (String)photoNumber;
-                while (num.length() < 5)
-                    num = "0" + num;
-
-                String filename = "/car_" + num;
-
-                DynamicJsonDocument doc(1024);
-                doc["id"] = num;
-                doc["image"] = filename + "jpg";
-                doc["totalPixels"] = totalPixels;
-                doc["darkPixels"] = darkPixels;
-                doc["whitePixels"] = totalPixels - darkPixels;
-                doc["darkRatio"] = darkRatio;
-                doc["distance"] = lastDistance;
-
-                if (savePhotoToSD(filename.c_str(), hi_res_fb, doc))
-                {
-                    Serial.println("Photo saved successfully: " + filename);
-                    savePreferences();
-                    vTaskDelay(250 / portTICK_PERIOD_MS);
-                }
-                else
-                {
-                    Serial.println("Failed to save photo");
-                }
-            }
+            saveZonePhotos(zoneMask, hi_res_fb);
         }
         else
         {
@@ -171,8 +340,26 @@ void takeHighQualityPhoto(int darkPixels, int totalPixels, float darkRatio)
         Serial.println("High resolution camera capture failed");
     }
 
-    vTaskDelay(250 / portTICK_PERIOD_MS);
-    switchToDetectionMode();
-    vTaskDelay(1500 / portTICK_PERIOD_MS);
+    // Сигнал вспышкой подаётся после съёмки и не задерживает фото;
+    // засветку от неё поглощает ожидание экспозиции режима детекции
+    onFlash();
+    vTaskDelay(500 / portTICK_PERIOD_MS);
+    offFlash();
+
+    cameraUnlock();
+    cameraRelease(OWNER_DETECTOR);
+
+    // Экспозиция режима детекции ждётся под арендой этого профиля: иначе
+    // между освобождением и ожиданием камеру может занять поток, и
+    // ожидание измеряло бы его кадры
+    if (cameraAcquire(OWNER_DETECTOR, detectionProfile(), nullptr))
+    {
+        bool converged;
+        cameraLock();
+        uint32_t settleMs = waitForExposure(settings.settle_max, settings.settle_tolerance, converged);
+        Serial.printf("Detection mode settled in %u ms%s\n", (unsigned)settleMs, converged ? "" : " (ceiling)");
+        cameraUnlock();
+        cameraRelease(OWNER_DETECTOR);
+    }
     timeInterval = millis();
 }
\ No newline at end of file
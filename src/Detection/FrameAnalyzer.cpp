@@ -0,0 +1,414 @@
+/**
+ * @file FrameAnalyzer.cpp
+ * @brief Реализация анализа полутонового кадра по зонам детекции
+ */
+
+#include "Detection/FrameAnalyzer.hpp"
+#include "Detection/FrameKernels.hpp"
+#include "Detection/IntegralImage.hpp"
+#include "Detection/BackgroundModel.hpp"
+#include "Detection/Histogram.hpp"
+#include "Detection/BlobLabeler.hpp"
+#include "Config/Config.hpp"
+#include <stdlib.h>
+
+// Внешние объявления
+extern Settings settings;
+
+// Состояние зон детекции
+ZoneState zoneStates[MAX_DETECTION_ZONES];
+
+// Фильтр статичных кадров
+MotionGate motionGate;
+
+// Интегральное изображение последнего проанализированного кадра
+static IntegralImage integralImage;
+static bool integralImageValid = false;
+
+// Шаг прореживания последнего проанализированного кадра
+static int analysisStep = 1;
+
+// Модель фона для детекции по разности с фоном
+static BackgroundModel backgroundModel;
+
+// Таблица серий для выделения связных областей
+static BlobLabeler blobLabeler;
+
+// Наибольшая ширина кадра сенсора (UXGA)
+#define MAX_FRAME_WIDTH 1600
+
+/**
+ * @brief Есть ли зоны в переходном состоянии (ARRIVING или LEAVING)
+ */
+bool zonesVoting()
+{
+    for (int i = 0; i < settings.zone_count; i++)
+    {
+        OccupancyState state = zoneStates[i].tracker.state;
+        if (state == ZONE_ARRIVING || state == ZONE_LEAVING)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Занята ли хотя бы одна зона
+ */
+bool zonesOccupied()
+{
+    for (int i = 0; i < settings.zone_count; i++)
+    {
+        if (zoneStates[i].occupied)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Анализ кадра детекции, если сцена изменилась
+ *
+ * Неизменившаяся сцена не анализируется, кроме кадров идущего голосования:
+ * остановившийся автомобиль иначе оставил бы зону в ARRIVING навсегда.
+ * @param analyzed true, если кадр прошёл фильтр статичных кадров
+ * @return Битовая маска зон, в которых прибытие подтверждено на этом кадре
+ */
+uint32_t detectInFrame(const uint8_t *buf, int width, int height, int distance, bool &analyzed)
+{
+    analyzed = zonesVoting() || motionGateCheck(motionGate, buf, width, height, settings.motion_gate);
+    return analyzed ? analyzeImage(buf, width, height, distance) : 0;
+}
+
+/**
+ * @brief Анализ кадра для детектирования
+ *
+ * Все зоны оцениваются за один проход по строкам кадра.
+ * Решение по кадру - лишь голос автомата зоны: съёмка и освобождение
+ * происходят после N положительных или отрицательных голосов из M.
+ * Не зависит от камеры: принимает полутоновый буфер и расстояние,
+ * измеренное для этого кадра, поэтому годится для воспроизведения
+ * записанных кадров на хосте.
+ * @param distance Показание датчика расстояния для этого кадра, 0 - нет данных
+ * @return Битовая маска зон, в которых прибытие подтверждено на этом кадре
+ */
+uint32_t analyzeImage(const uint8_t *buf, int frameWidth, int frameHeight, int distance)
+{
+    const int zoneCount = settings.zone_count;
+    PixelRect regions[MAX_DETECTION_ZONES];
+    uint32_t counts[MAX_DETECTION_ZONES] = {0};
+    float textures[MAX_DETECTION_ZONES] = {0};
+    const bool useTexture = settings.texture > 0;
+
+    // Прореживание: все проходы идут по уменьшенной копии кадра,
+    // а счётчики пикселей масштабируются обратно на step^2
+    const int step = (settings.stride == 2 || settings.stride == 4) ? settings.stride : 1;
+    const uint8_t *image = buf;
+    int width = frameWidth;
+    int height = frameHeight;
+    static uint8_t *decimated = nullptr;
+    static size_t decimatedSize = 0;
+    analysisStep = 1;
+
+    if (step > 1)
+    {
+        size_t size = (size_t)((width + step - 1) / step) * ((height + step - 1) / step);
+        if (size > decimatedSize)
+        {
+            free(decimated);
+            decimated = (uint8_t *)malloc(size);
+            decimatedSize = decimated ? size : 0;
+        }
+
+        if (decimated)
+        {
+            width = (width + step - 1) / step;
+            height = (height + step - 1) / step;
+            analysisStep = step;
+        }
+    }
+    const uint32_t scale = analysisStep * analysisStep;
+
+    for (int i = 0; i < zoneCount; i++)
+    {
+        const DetectionZone &zone = settings.zones[i];
+        int min_x = max(0, (zone.x + analysisStep - 1) / analysisStep);
+        int min_y = max(0, (zone.y + analysisStep - 1) / analysisStep);
+        int max_x = min((zone.x + zone.width + analysisStep - 1) / analysisStep, width);
+        int max_y = min((zone.y + zone.height + analysisStep - 1) / analysisStep, height);
+
+        regions[i].x = min_x;
+        regions[i].y = min_y;
+        regions[i].width = max(0, max_x - min_x);
+        regions[i].height = max(0, max_y - min_y);
+        regions[i].threshold = zone.threshold;
+        zoneStates[i].totalPixels = regions[i].width * regions[i].height * scale;
+    }
+
+    if (analysisStep > 1)
+    {
+        // Копируются только строки и столбцы, покрытые зонами; интегральному
+        // изображению нужен весь кадр
+        PixelRect area = {0, 0, width, height, 0};
+        if (settings.integral_mode == INTEGRAL_OFF)
+        {
+            int x1 = 0;
+            int y1 = 0;
+            area.x = width;
+            area.y = height;
+            for (int i = 0; i < zoneCount; i++)
+            {
+                if (regions[i].width == 0 || regions[i].height == 0)
+                    continue;
+                area.x = min(area.x, regions[i].x);
+                area.y = min(area.y, regions[i].y);
+                x1 = max(x1, regions[i].x + regions[i].width);
+                y1 = max(y1, regions[i].y + regions[i].height);
+            }
+            area.width = max(0, x1 - area.x);
+            area.height = max(0, y1 - area.y);
+        }
+
+        decimateFrame(buf, frameWidth, analysisStep, area, decimated, width);
+        image = decimated;
+    }
+
+    // Модель фона действует, только если её буфер выделен для этого кадра;
+    // иначе зоны считаются по порогу, как без неё
+    bool backgroundActive = false;
+    if (settings.background && backgroundModelInit(backgroundModel, width, height))
+    {
+        if (!backgroundModel.seeded)
+            backgroundModelSeed(backgroundModel, image);
+        backgroundActive = true;
+    }
+
+    // Адаптивный порог: гистограмма зоны строится одним проходом,
+    // и число тёмных пикселей берётся из неё же. С текстурой гистограммы
+    // строятся в том же проходе, что и текстура
+    static uint32_t bins[MAX_DETECTION_ZONES][HISTOGRAM_BINS];
+    uint32_t *histograms[MAX_DETECTION_ZONES] = {nullptr};
+    bool counted[MAX_DETECTION_ZONES] = {false};
+    for (int i = 0; i < zoneCount; i++)
+    {
+        ZoneState &state = zoneStates[i];
+        state.hasHistogram = false;
+        state.threshold = regions[i].threshold;
+        if (regions[i].threshold == 0 && !backgroundActive && regions[i].width > 0)
+            histograms[i] = bins[i];
+    }
+
+    const bool textureDone = useTexture && !backgroundActive;
+    if (textureDone)
+        analyzeRegionsTexture(image, width, regions, zoneCount, counts, textures, histograms);
+
+    for (int i = 0; i < zoneCount; i++)
+    {
+        if (!histograms[i])
+            continue;
+
+        ZoneState &state = zoneStates[i];
+        if (!textureDone)
+            buildHistogram(image, width, regions[i], bins[i]);
+        histogramStats(bins[i], state.histogram);
+
+        // На однородной зоне порог Оцу бессмыслен: берётся последний надёжный
+        if (state.histogram.otsuReliable)
+            state.autoThreshold = state.histogram.otsuThreshold;
+        regions[i].threshold = state.autoThreshold;
+        counts[i] = histogramCountBelow(bins[i], regions[i].threshold);
+        counted[i] = true;
+        state.threshold = regions[i].threshold;
+        state.hasHistogram = true;
+    }
+
+    integralImageValid = false;
+    if (settings.integral_mode != INTEGRAL_OFF &&
+        integralImageInit(integralImage, width, height, settings.integral_mode == INTEGRAL_MASK_LUMA))
+    {
+        integralImageBuild(integralImage, image, regions[0].threshold);
+        integralImageValid = true;
+    }
+
+    if (backgroundActive)
+    {
+        // Текстура в этом режиме требует отдельного прохода
+        if (useTexture)
+            analyzeRegionsTexture(image, width, regions, zoneCount, counts, textures, nullptr);
+
+        for (int i = 0; i < zoneCount; i++)
+        {
+            // Фон обновляется только в зонах, свободных на момент кадра
+            counts[i] = backgroundModelProcess(backgroundModel, image, regions[i], settings.fg_threshold,
+                                               settings.bg_shift, zoneStates[i].tracker.state == ZONE_EMPTY);
+        }
+    }
+    else if (!textureDone && !settings.blob)
+    {
+        // Зоны с порогом интегрального изображения считаются по нему,
+        // остальные - одним проходом по кадру
+        PixelRect sweepRegions[MAX_DETECTION_ZONES];
+        uint32_t sweepCounts[MAX_DETECTION_ZONES];
+        bool fromIntegral[MAX_DETECTION_ZONES] = {false};
+        for (int i = 0; i < zoneCount; i++)
+        {
+            sweepRegions[i] = regions[i];
+            fromIntegral[i] = !counted[i] && integralImageValid && regions[i].threshold == integralImage.threshold;
+            if (counted[i] || fromIntegral[i])
+                sweepRegions[i].width = 0;
+        }
+
+        countDarkPixelsRegions(image, width, sweepRegions, zoneCount, sweepCounts);
+
+        for (int i = 0; i < zoneCount; i++)
+        {
+            if (fromIntegral[i])
+                counts[i] = integralImageDarkCount(integralImage, regions[i].x, regions[i].y,
+                                                   regions[i].width, regions[i].height);
+            else if (!counted[i])
+                counts[i] = sweepCounts[i];
+        }
+    }
+
+    // Связные области; в режиме порога проход разметки заодно даёт
+    // число тёмных пикселей. Таблица серий рассчитана на худший случай
+    // наибольшей зоны (чередующиеся пиксели)
+    if (settings.blob)
+    {
+        int capacity = 0;
+        for (int i = 0; i < zoneCount; i++)
+            capacity = max(capacity, blobRunCapacity(regions[i].width, regions[i].height));
+        static int failedCapacity = 0;
+        if (!blobLabelerInit(blobLabeler, capacity) && capacity != failedCapacity)
+        {
+            Serial.printf("Blob run table allocation failed: %d runs, using dark pixel count\n", capacity);
+            failedCapacity = capacity;
+        }
+    }
+
+    for (int i = 0; i < zoneCount; i++)
+    {
+        ZoneState &state = zoneStates[i];
+        state.hasBlob = false;
+        if (!settings.blob || regions[i].width == 0)
+            continue;
+
+        const PixelRect &r = regions[i];
+        blobLabelerReset(blobLabeler);
+        for (int y = r.y; y < r.y + r.height; y++)
+        {
+            if (backgroundActive)
+            {
+                static uint8_t mask[MAX_FRAME_WIDTH];
+                backgroundModelMaskRow(backgroundModel, image, y, r.x, r.width, settings.fg_threshold, mask);
+                blobAddMaskRow(blobLabeler, mask, r.x, r.width, y);
+            }
+            else
+            {
+                blobAddDarkRow(blobLabeler, image + y * width + r.x, r.x, r.width, y, r.threshold);
+            }
+        }
+
+        if (!backgroundActive)
+            counts[i] = blobLabeler.pixels;
+
+        // Без полной таблицы наибольшая область была бы занижена:
+        // зона оценивается по числу тёмных пикселей
+        if (blobLabeler.overflow)
+            continue;
+        state.hasBlob = blobLargest(blobLabeler, state.blob);
+        if (state.hasBlob && analysisStep > 1)
+        {
+            state.blob.area *= scale;
+            state.blob.minX *= analysisStep;
+            state.blob.minY *= analysisStep;
+            state.blob.maxX = state.blob.maxX * analysisStep + analysisStep - 1;
+            state.blob.maxY = state.blob.maxY * analysisStep + analysisStep - 1;
+            state.blob.centroidX *= analysisStep;
+            state.blob.centroidY *= analysisStep;
+        }
+    }
+
+    uint32_t triggeredZones = 0;
+    for (int i = 0; i < zoneCount; i++)
+    {
+        ZoneState &state = zoneStates[i];
+        const DetectionZone &zone = settings.zones[i];
+
+        state.darkPixels = (int)(counts[i] * scale);
+        state.darkRatio = state.totalPixels > 0 ? ((float)state.darkPixels / state.totalPixels) : 0.0;
+        // На прореженном кадре соседи отстоят на step пикселей: энергия
+        // приводится к единичному расстоянию, чтобы порог не зависел от шага
+        state.texture = textures[i] / scale;
+
+        // Голос кадра: кадр и датчик расстояния подтверждают автомобиль
+        bool present = false;
+        if (state.darkRatio > settings.dark_min && state.darkRatio < settings.dark_max)
+        {
+            // Плоские тёмные пятна (тени, мокрый асфальт) отсекаются по текстуре
+            int area = (settings.blob && state.hasBlob) ? (int)state.blob.area : state.darkPixels;
+            present = area > zone.area &&
+                      (!useTexture || state.texture >= settings.texture) &&
+                      distance != 0 &&
+                      settings.distance > distance;
+        }
+
+        state.vote = present;
+        OccupancyEvent event = occupancyUpdate(state.tracker, present, settings.confirm_n, settings.confirm_m);
+        state.occupied = occupancyIsOccupied(state.tracker);
+
+        if (event == OCCUPANCY_ARRIVED)
+        {
+            triggeredZones |= 1u << i;
+            Serial.printf("Car detected in zone %d! Dark pixels: %d, ratio: %.2f, threshold: %d, texture: %.0f, distance: %d\n",
+                          i, state.darkPixels, state.darkRatio, state.threshold, state.texture, distance);
+        }
+        else if (event == OCCUPANCY_DEPARTED)
+        {
+            Serial.printf("Car left zone %d! Dark pixels: %d, ratio: %.2f, distance: %d\n",
+                          i, state.darkPixels, state.darkRatio, distance);
+        }
+        else
+        {
+            Serial.printf("Zone %d %s (vote %d)! Dark pixels: %d, ratio: %.2f, threshold: %d, texture: %.0f, distance: %d\n",
+                          i, occupancyStateName(state.tracker.state), present ? 1 : 0, state.darkPixels,
+                          state.darkRatio, state.threshold, state.texture, distance);
+        }
+    }
+
+    return triggeredZones;
+}
+
+/**
+ * @brief Сброс состояния занятости всех зон
+ */
+void resetZones()
+{
+    for (int i = 0; i < MAX_DETECTION_ZONES; i++)
+    {
+        zoneStates[i].occupied = false;
+        zoneStates[i].autoThreshold = 0;
+        occupancyReset(zoneStates[i].tracker);
+    }
+    motionGateReset(motionGate);
+}
+
+/**
+ * @brief Статистика произвольной области последнего кадра по интегральному изображению
+ */
+bool getRegionStats(int x, int y, int width, int height, RegionStats &stats)
+{
+    if (!integralImageValid)
+        return false;
+
+    // Интегральное изображение построено по прореженному кадру
+    const int step = analysisStep;
+    int x0 = (x + step - 1) / step;
+    int y0 = (y + step - 1) / step;
+    int x1 = (x + width + step - 1) / step;
+    int y1 = (y + height + step - 1) / step;
+    if (!integralImageStats(integralImage, x0, y0, x1 - x0, y1 - y0, stats))
+        return false;
+
+    stats.totalPixels *= step * step;
+    stats.darkPixels *= step * step;
+    return true;
+}
\ No newline at end of file
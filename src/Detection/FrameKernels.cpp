@@ -0,0 +1,354 @@
+/**
+ * @file FrameKernels.cpp
+ * @brief Реализация вычислительных ядер анализа кадра
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include <string.h>
+
+namespace
+{
+    const uint32_t SWAR_ONES = 0x01010101u;
+    const uint32_t SWAR_HIGH = 0x80808080u;
+
+    /**
+     * @brief Побайтное сравнение a < t для четырёх пикселей слова
+     * @return Слово, в котором старший бит каждого байта равен 1 там, где a < t
+     */
+    inline uint32_t lessThanMask(uint32_t a, uint32_t t)
+    {
+        // Сравнение младших 7 бит без заёма между байтами
+        uint32_t low = (a | SWAR_HIGH) - (t & ~SWAR_HIGH);
+        // Старшие биты различаются: a < t, если у a он сброшен.
+        // Старшие биты совпадают: решает сравнение младших 7 бит.
+        return ((~a & t) | (~(a ^ t) & ~low)) & SWAR_HIGH;
+    }
+
+    /**
+     * @brief Подсчёт установленных старших битов байтов слова
+     */
+    inline uint32_t popcountHighBits(uint32_t mask)
+    {
+        return ((mask >> 7) * SWAR_ONES) >> 24;
+    }
+
+    inline int min(int a, int b) { return a < b ? a : b; }
+    inline int max(int a, int b) { return a > b ? a : b; }
+
+    /**
+     * @brief Тёмные пиксели и градиентная энергия сегмента строки
+     *
+     * Энергия - сумма dx^2 + dy^2 по соседям справа и снизу внутри области;
+     * next равен nullptr для последней строки области.
+     */
+    inline uint32_t darkAndEnergyRow(const uint8_t *row, const uint8_t *next, int length, int threshold,
+                                     uint32_t &energy)
+    {
+        uint32_t count = 0;
+        uint32_t sum = 0;
+        const int last = length - 1;
+
+        if (next)
+        {
+            for (int i = 0; i < last; i++)
+            {
+                int p = row[i];
+                int dx = row[i + 1] - p;
+                int dy = next[i] - p;
+                count += p < threshold;
+                sum += dx * dx + dy * dy;
+            }
+            int dy = next[last] - row[last];
+            sum += dy * dy;
+        }
+        else
+        {
+            for (int i = 0; i < last; i++)
+            {
+                int p = row[i];
+                int dx = row[i + 1] - p;
+                count += p < threshold;
+                sum += dx * dx;
+            }
+        }
+
+        energy = sum;
+        return count + (row[last] < threshold);
+    }
+
+    /**
+     * @brief Гистограмма яркости и градиентная энергия сегмента строки
+     *
+     * Как darkAndEnergyRow(), но вместо сравнения с порогом каждый пиксель
+     * добавляется в гистограмму из 256 корзин.
+     */
+    inline void histogramAndEnergyRow(const uint8_t *row, const uint8_t *next, int length, uint32_t *bins,
+                                      uint32_t &energy)
+    {
+        uint32_t sum = 0;
+        const int last = length - 1;
+
+        if (next)
+        {
+            for (int i = 0; i < last; i++)
+            {
+                int p = row[i];
+                int dx = row[i + 1] - p;
+                int dy = next[i] - p;
+                bins[p]++;
+                sum += dx * dx + dy * dy;
+            }
+            int dy = next[last] - row[last];
+            sum += dy * dy;
+        }
+        else
+        {
+            for (int i = 0; i < last; i++)
+            {
+                int p = row[i];
+                int dx = row[i + 1] - p;
+                bins[p]++;
+                sum += dx * dx;
+            }
+        }
+
+        bins[row[last]]++;
+        energy = sum;
+    }
+
+    inline uint32_t countDarkScalar(const uint8_t *row, int length, int threshold)
+    {
+        uint32_t count = 0;
+        for (int i = 0; i < length; i++)
+        {
+            count += row[i] < threshold;
+        }
+        return count;
+    }
+}
+
+/**
+ * @brief Подсчёт пикселей строки темнее порога
+ *
+ * Невыровненные края строки обрабатываются побайтно, середина - словами
+ * по четыре пикселя.
+ */
+uint32_t countDarkPixelsRow(const uint8_t *row, int length, int threshold)
+{
+    if (length <= 0 || threshold <= 0)
+        return 0;
+    if (threshold > 255)
+        return length;
+
+    int head = (int)((4 - ((uintptr_t)row & 3)) & 3);
+    if (head > length)
+        head = length;
+
+    uint32_t count = countDarkScalar(row, head, threshold);
+    row += head;
+    length -= head;
+
+    const uint32_t t = (uint32_t)threshold * SWAR_ONES;
+    int words = length >> 2;
+    for (int i = 0; i < words; i++)
+    {
+        uint32_t pixels;
+        memcpy(&pixels, __builtin_assume_aligned(row, 4), sizeof(pixels));
+        count += popcountHighBits(lessThanMask(pixels, t));
+        row += 4;
+    }
+
+    return count + countDarkScalar(row, length & 3, threshold);
+}
+
+/**
+ * @brief Подсчёт пикселей прямоугольной области темнее порога
+ */
+uint32_t countDarkPixels(const uint8_t *image, int stride, int x, int y, int width, int height, int threshold)
+{
+    uint32_t count = 0;
+    const uint8_t *row = image + y * stride + x;
+    for (int r = 0; r < height; r++)
+    {
+        count += countDarkPixelsRow(row, width, threshold);
+        row += stride;
+    }
+    return count;
+}
+
+/**
+ * @brief Подсчёт тёмных пикселей нескольких областей за один проход по кадру
+ *
+ * Строки кадра обходятся сверху вниз один раз; каждая строка читается
+ * только теми областями, которые её пересекают. Области должны лежать
+ * внутри кадра.
+ */
+void countDarkPixelsRegions(const uint8_t *image, int stride, const PixelRect *regions, int regionCount, uint32_t *counts)
+{
+    int top = 0;
+    int bottom = 0;
+    bool found = false;
+    for (int i = 0; i < regionCount; i++)
+    {
+        counts[i] = 0;
+        const PixelRect &r = regions[i];
+        if (r.width <= 0 || r.height <= 0)
+            continue;
+
+        top = found ? min(top, r.y) : r.y;
+        bottom = found ? max(bottom, r.y + r.height) : r.y + r.height;
+        found = true;
+    }
+
+    for (int y = top; y < bottom; y++)
+    {
+        const uint8_t *row = image + y * stride;
+        for (int i = 0; i < regionCount; i++)
+        {
+            const PixelRect &r = regions[i];
+            if (y >= r.y && y < r.y + r.height)
+                counts[i] += countDarkPixelsRow(row + r.x, r.width, r.threshold);
+        }
+    }
+}
+
+/**
+ * @brief Тёмные пиксели и текстура нескольких областей за один проход
+ *
+ * Как countDarkPixelsRegions(), но дополнительно считает текстуру -
+ * средний квадрат разности соседних пикселей (dx^2 и dy^2) на пару
+ * соседей внутри области, читая каждую строку кадра один раз вместе
+ * со следующей.
+ * @param histograms По гистограмме из 256 корзин на область или nullptr.
+ *        Для области с гистограммой тёмные пиксели не считаются: порог
+ *        выбирается по гистограмме после прохода.
+ */
+void analyzeRegionsTexture(const uint8_t *image, int stride, const PixelRect *regions, int regionCount,
+                           uint32_t *counts, float *textures, uint32_t *const *histograms)
+{
+    uint64_t energies[16] = {0};
+    const int maxRegions = (int)(sizeof(energies) / sizeof(energies[0]));
+    if (regionCount > maxRegions)
+        regionCount = maxRegions;
+
+    int top = 0;
+    int bottom = 0;
+    bool found = false;
+    for (int i = 0; i < regionCount; i++)
+    {
+        counts[i] = 0;
+        textures[i] = 0;
+        if (histograms && histograms[i])
+            memset(histograms[i], 0, 256 * sizeof(uint32_t));
+        const PixelRect &r = regions[i];
+        if (r.width <= 0 || r.height <= 0)
+            continue;
+
+        top = found ? min(top, r.y) : r.y;
+        bottom = found ? max(bottom, r.y + r.height) : r.y + r.height;
+        found = true;
+    }
+
+    for (int y = top; y < bottom; y++)
+    {
+        const uint8_t *row = image + y * stride;
+        for (int i = 0; i < regionCount; i++)
+        {
+            const PixelRect &r = regions[i];
+            if (r.width <= 0 || y < r.y || y >= r.y + r.height)
+                continue;
+
+            const uint8_t *next = (y + 1 < r.y + r.height) ? row + stride + r.x : nullptr;
+            uint32_t energy;
+            if (histograms && histograms[i])
+                histogramAndEnergyRow(row + r.x, next, r.width, histograms[i], energy);
+            else
+                counts[i] += darkAndEnergyRow(row + r.x, next, r.width, r.threshold, energy);
+            energies[i] += energy;
+        }
+    }
+
+    // Нормировка на число пар соседей: dx - внутри строк, dy - между строками
+    for (int i = 0; i < regionCount; i++)
+    {
+        const int w = max(0, regions[i].width);
+        const int h = max(0, regions[i].height);
+        uint32_t pairs = (uint32_t)h * max(0, w - 1) + (uint32_t)max(0, h - 1) * w;
+        if (pairs > 0)
+            textures[i] = (float)energies[i] / pairs;
+    }
+}
+
+/**
+ * @brief Прореживание области кадра: каждый step-й пиксель каждой step-й строки
+ *
+ * area задана в координатах прореженного кадра шириной outWidth; пиксель
+ * (x, y) результата берётся из (x * step, y * step) исходного кадра.
+ * Остальная часть out не изменяется.
+ */
+void decimateFrame(const uint8_t *image, int width, int step, const PixelRect &area, uint8_t *out, int outWidth)
+{
+    for (int y = area.y; y < area.y + area.height; y++)
+    {
+        const uint8_t *src = image + y * step * width + area.x * step;
+        uint8_t *dst = out + y * outWidth + area.x;
+        for (int x = 0; x < area.width; x++)
+        {
+            dst[x] = *src;
+            src += step;
+        }
+    }
+}
+
+/**
+ * @brief Резкость кадра: дисперсия лапласиана по внутренним пикселям
+ *
+ * Лапласиан 4p - сверху - снизу - слева - справа; размытый или
+ * недоэкспонированный кадр даёт меньшую дисперсию.
+ */
+float laplacianVariance(const uint8_t *image, int width, int height)
+{
+    if (width < 3 || height < 3)
+        return 0;
+
+    int64_t sum = 0;
+    uint64_t sumSquares = 0;
+    for (int y = 1; y < height - 1; y++)
+    {
+        const uint8_t *up = image + (y - 1) * width;
+        const uint8_t *row = up + width;
+        const uint8_t *down = row + width;
+        int32_t rowSum = 0;
+        uint32_t rowSquares = 0;
+        for (int x = 1; x < width - 1; x++)
+        {
+            int lap = 4 * row[x] - up[x] - down[x] - row[x - 1] - row[x + 1];
+            rowSum += lap;
+            rowSquares += lap * lap;
+        }
+        sum += rowSum;
+        sumSquares += rowSquares;
+    }
+
+    const double n = (double)(width - 2) * (height - 2);
+    const double mean = sum / n;
+    return (float)(sumSquares / n - mean * mean);
+}
+
+/**
+ * @brief Средняя яркость по каждому step-му пикселю буфера
+ */
+uint32_t meanLuma(const uint8_t *image, size_t count, int step)
+{
+    if (step < 1)
+        step = 1;
+
+    uint32_t sum = 0;
+    uint32_t samples = 0;
+    for (size_t i = 0; i < count; i += step)
+    {
+        sum += image[i];
+        samples++;
+    }
+    return samples ? sum / samples : 0;
+}
\ No newline at end of file
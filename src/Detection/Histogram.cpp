@@ -0,0 +1,166 @@
+/**
+ * @file Histogram.cpp
+ * @brief Реализация гистограммы яркости и порога Оцу
+ */
+
+#include "Detection/Histogram.hpp"
+#include <string.h>
+
+namespace
+{
+    /**
+     * @brief Наименьшая яркость, до которой накоплено не меньше target пикселей
+     */
+    uint8_t percentile(const uint32_t *bins, uint32_t target)
+    {
+        uint32_t cumulative = 0;
+        for (int i = 0; i < HISTOGRAM_BINS; i++)
+        {
+            cumulative += bins[i];
+            if (cumulative >= target)
+                return (uint8_t)i;
+        }
+        return HISTOGRAM_BINS - 1;
+    }
+}
+
+/**
+ * @brief Построение гистограммы области за один проход
+ */
+void buildHistogram(const uint8_t *image, int stride, const PixelRect &region, uint32_t *bins)
+{
+    memset(bins, 0, HISTOGRAM_BINS * sizeof(uint32_t));
+
+    const uint8_t *row = image + region.y * stride + region.x;
+    for (int y = 0; y < region.height; y++)
+    {
+        for (int x = 0; x < region.width; x++)
+        {
+            bins[row[x]]++;
+        }
+        row += stride;
+    }
+}
+
+/**
+ * @brief Порог по методу Оцу
+ *
+ * Максимизирует межклассовую дисперсию разбиения на тёмные и светлые
+ * пиксели.
+ * @return Порог t: пиксели с яркостью < t считаются тёмными
+ */
+int otsuThreshold(const uint32_t *bins)
+{
+    float separation;
+    float betweenVariance;
+    return otsuThreshold(bins, separation, betweenVariance);
+}
+
+/**
+ * @brief Порог по методу Оцу с качеством разбиения
+ * @param separation Разность средних светлого и тёмного классов
+ * @param betweenVariance Межклассовая дисперсия выбранного разбиения
+ */
+int otsuThreshold(const uint32_t *bins, float &separation, float &betweenVariance)
+{
+    separation = 0;
+    betweenVariance = 0;
+
+    uint32_t total = 0;
+    float sumAll = 0;
+    for (int i = 0; i < HISTOGRAM_BINS; i++)
+    {
+        total += bins[i];
+        sumAll += (float)i * bins[i];
+    }
+    if (total == 0)
+        return 0;
+
+    uint32_t weightDark = 0;
+    float sumDark = 0;
+    float bestVariance = -1;
+    float bestSeparation = 0;
+    int best = 0;
+
+    for (int t = 0; t < HISTOGRAM_BINS - 1; t++)
+    {
+        weightDark += bins[t];
+        if (weightDark == 0)
+            continue;
+
+        uint32_t weightLight = total - weightDark;
+        if (weightLight == 0)
+            break;
+
+        sumDark += (float)t * bins[t];
+        float meanDark = sumDark / weightDark;
+        float meanLight = (sumAll - sumDark) / weightLight;
+        float diff = meanDark - meanLight;
+        float variance = (float)weightDark * (float)weightLight * diff * diff;
+
+        if (variance > bestVariance)
+        {
+            bestVariance = variance;
+            bestSeparation = -diff;
+            best = t;
+        }
+    }
+
+    if (bestVariance > 0)
+    {
+        separation = bestSeparation;
+        betweenVariance = bestVariance / ((float)total * total);
+    }
+    return best + 1;
+}
+
+/**
+ * @brief Число пикселей с яркостью ниже порога
+ */
+uint32_t histogramCountBelow(const uint32_t *bins, int threshold)
+{
+    if (threshold > HISTOGRAM_BINS)
+        threshold = HISTOGRAM_BINS;
+
+    uint32_t count = 0;
+    for (int i = 0; i < threshold; i++)
+    {
+        count += bins[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Среднее, дисперсия, перцентили и порог Оцу по гистограмме
+ *
+ * Порог Оцу считается надёжным по OTSU_MIN_SEPARATION и
+ * OTSU_MIN_EFFECTIVENESS.
+ */
+void histogramStats(const uint32_t *bins, HistogramStats &stats)
+{
+    stats = HistogramStats();
+
+    float sum = 0;
+    float sumSquares = 0;
+    for (int i = 0; i < HISTOGRAM_BINS; i++)
+    {
+        stats.totalPixels += bins[i];
+        sum += (float)i * bins[i];
+        sumSquares += (float)i * i * bins[i];
+    }
+    if (stats.totalPixels == 0)
+        return;
+
+    stats.mean = sum / stats.totalPixels;
+    stats.variance = sumSquares / stats.totalPixels - stats.mean * stats.mean;
+    stats.p10 = percentile(bins, (stats.totalPixels * 10 + 99) / 100);
+    stats.p50 = percentile(bins, (stats.totalPixels * 50 + 99) / 100);
+    stats.p90 = percentile(bins, (stats.totalPixels * 90 + 99) / 100);
+
+    float betweenVariance;
+    stats.otsuThreshold = otsuThreshold(bins, stats.otsuSeparation, betweenVariance);
+    if (stats.variance > 0)
+        stats.otsuEffectiveness = betweenVariance / stats.variance;
+    stats.otsuReliable = stats.otsuSeparation >= OTSU_MIN_SEPARATION &&
+                         stats.otsuEffectiveness >= OTSU_MIN_EFFECTIVENESS;
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/**
+ * @file IntegralImage.cpp
+ * @brief Реализация интегрального изображения
+ */
+
+#include "Detection/IntegralImage.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    /**
+     * @brief Сумма прямоугольника по таблице: D - B - C + A
+     */
+    inline uint32_t rectSum(const uint32_t *table, int tableWidth, int x, int y, int width, int height)
+    {
+        const uint32_t *top = table + y * tableWidth + x;
+        const uint32_t *bottom = top + height * tableWidth;
+        return bottom[width] - bottom[0] - top[width] + top[0];
+    }
+
+    /**
+     * @brief Обрезка прямоугольника по границам кадра
+     */
+    inline bool clipRect(const IntegralImage &ii, int &x, int &y, int &width, int &height)
+    {
+        int x1 = x + width;
+        int y1 = y + height;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+        if (x1 > ii.width) x1 = ii.width;
+        if (y1 > ii.height) y1 = ii.height;
+        width = x1 - x;
+        height = y1 - y;
+        return width > 0 && height > 0;
+    }
+}
+
+/**
+ * @brief Выделение памяти под таблицы
+ *
+ * Повторный вызов с теми же размерами не выделяет память заново.
+ */
+bool integralImageInit(IntegralImage &ii, int width, int height, bool withLuma)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    if (ii.mask && ii.width == width && ii.height == height && (ii.luma != nullptr) == withLuma)
+        return true;
+
+    integralImageFree(ii);
+
+    size_t cells = (size_t)(width + 1) * (height + 1);
+    ii.mask = (uint32_t *)calloc(cells, sizeof(uint32_t));
+    if (withLuma)
+        ii.luma = (uint32_t *)calloc(cells, sizeof(uint32_t));
+
+    if (!ii.mask || (withLuma && !ii.luma))
+    {
+        integralImageFree(ii);
+        return false;
+    }
+
+    ii.width = width;
+    ii.height = height;
+    return true;
+}
+
+/**
+ * @brief Освобождение таблиц
+ */
+void integralImageFree(IntegralImage &ii)
+{
+    free(ii.mask);
+    free(ii.luma);
+    ii.mask = nullptr;
+    ii.luma = nullptr;
+    ii.width = 0;
+    ii.height = 0;
+}
+
+/**
+ * @brief Построение таблиц за один проход по кадру
+ *
+ * Первая строка и первый столбец таблиц остаются нулевыми.
+ */
+void integralImageBuild(IntegralImage &ii, const uint8_t *image, int threshold)
+{
+    const int tableWidth = ii.width + 1;
+    ii.threshold = threshold;
+
+    for (int y = 0; y < ii.height; y++)
+    {
+        const uint8_t *row = image + y * ii.width;
+        const uint32_t *maskAbove = ii.mask + y * tableWidth;
+        uint32_t *maskOut = ii.mask + (y + 1) * tableWidth;
+        uint32_t maskRow = 0;
+
+        if (ii.luma)
+        {
+            const uint32_t *lumaAbove = ii.luma + y * tableWidth;
+            uint32_t *lumaOut = ii.luma + (y + 1) * tableWidth;
+            uint32_t lumaRow = 0;
+
+            for (int x = 0; x < ii.width; x++)
+            {
+                maskRow += row[x] < threshold;
+                lumaRow += row[x];
+                maskOut[x + 1] = maskAbove[x + 1] + maskRow;
+                lumaOut[x + 1] = lumaAbove[x + 1] + lumaRow;
+            }
+        }
+        else
+        {
+            for (int x = 0; x < ii.width; x++)
+            {
+                maskRow += row[x] < threshold;
+                maskOut[x + 1] = maskAbove[x + 1] + maskRow;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Число тёмных пикселей прямоугольника
+ */
+uint32_t integralImageDarkCount(const IntegralImage &ii, int x, int y, int width, int height)
+{
+    if (!ii.mask || !clipRect(ii, x, y, width, height))
+        return 0;
+    return rectSum(ii.mask, ii.width + 1, x, y, width, height);
+}
+
+/**
+ * @brief Сумма яркости прямоугольника
+ */
+uint32_t integralImageLumaSum(const IntegralImage &ii, int x, int y, int width, int height)
+{
+    if (!ii.luma || !clipRect(ii, x, y, width, height))
+        return 0;
+    return rectSum(ii.luma, ii.width + 1, x, y, width, height);
+}
+
+/**
+ * @brief Статистика прямоугольника за O(1)
+ */
+bool integralImageStats(const IntegralImage &ii, int x, int y, int width, int height, RegionStats &stats)
+{
+    stats = RegionStats();
+    if (!ii.mask || !clipRect(ii, x, y, width, height))
+        return false;
+
+    stats.totalPixels = (uint32_t)width * height;
+    stats.darkPixels = rectSum(ii.mask, ii.width + 1, x, y, width, height);
+    stats.darkRatio = (float)stats.darkPixels / stats.totalPixels;
+    if (ii.luma)
+        stats.meanLuma = (float)rectSum(ii.luma, ii.width + 1, x, y, width, height) / stats.totalPixels;
+    return true;
+}
\ No newline at end of file
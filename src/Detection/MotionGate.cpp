@@ -0,0 +1,82 @@
+/**
+ * @file MotionGate.cpp
+ * @brief Реализация предварительной проверки изменений сцены
+ */
+
+#include "Detection/MotionGate.hpp"
+#include <string.h>
+
+/**
+ * @brief Построение сигнатуры кадра
+ *
+ * Каждая ячейка - среднее блока 2x2 в её центре, всего 768 чтений
+ * на кадр.
+ */
+void motionSignature(const uint8_t *image, int width, int height, uint8_t *signature)
+{
+    const int cellWidth = width / MOTION_SIGNATURE_COLS;
+    const int cellHeight = height / MOTION_SIGNATURE_ROWS;
+
+    for (int cy = 0; cy < MOTION_SIGNATURE_ROWS; cy++)
+    {
+        int y = cy * cellHeight + cellHeight / 2;
+        if (y + 1 >= height)
+            y = height - 2;
+        const uint8_t *row = image + y * width;
+
+        for (int cx = 0; cx < MOTION_SIGNATURE_COLS; cx++)
+        {
+            int x = cx * cellWidth + cellWidth / 2;
+            if (x + 1 >= width)
+                x = width - 2;
+
+            int sum = row[x] + row[x + 1] + row[x + width] + row[x + width + 1];
+            *signature++ = (uint8_t)((sum + 2) >> 2);
+        }
+    }
+}
+
+/**
+ * @brief Проверка, изменилась ли сцена
+ *
+ * Сравнение идёт с сигнатурой последнего проанализированного кадра,
+ * поэтому медленный дрейф освещения со временем тоже приводит к анализу.
+ * @return true, если кадр нужно анализировать
+ */
+bool motionGateCheck(MotionGate &gate, const uint8_t *image, int width, int height, int sensitivity)
+{
+    if (sensitivity <= 0 || width < 2 * MOTION_SIGNATURE_COLS || height < 2 * MOTION_SIGNATURE_ROWS)
+    {
+        gate.framesAnalyzed++;
+        return true;
+    }
+
+    uint8_t signature[MOTION_SIGNATURE_SIZE];
+    motionSignature(image, width, height, signature);
+
+    bool changed = !gate.hasReference;
+    for (int i = 0; i < MOTION_SIGNATURE_SIZE && !changed; i++)
+    {
+        int diff = signature[i] - gate.reference[i];
+        changed = diff > sensitivity || diff < -sensitivity;
+    }
+
+    if (!changed)
+    {
+        gate.framesGated++;
+        return false;
+    }
+
+    memcpy(gate.reference, signature, sizeof(signature));
+    gate.hasReference = true;
+    gate.framesAnalyzed++;
+    return true;
+}
+
+/**
+ * @brief Сброс опорной сигнатуры, следующий кадр будет проанализирован
+ */
+void motionGateReset(MotionGate &gate)
+{
+    gate.hasReference = false;
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+/**
+ * @file OccupancyTracker.cpp
+ * @brief Реализация автомата состояний занятости зоны
+ */
+
+#include "Detection/OccupancyTracker.hpp"
+
+namespace
+{
+    inline int countVotes(uint16_t votes)
+    {
+        int count = 0;
+        for (; votes; votes &= votes - 1)
+            count++;
+        return count;
+    }
+
+    inline void enter(OccupancyTracker &tracker, OccupancyState state)
+    {
+        tracker.state = state;
+        tracker.votes = 0;
+        tracker.samples = 0;
+    }
+
+    inline void record(OccupancyTracker &tracker, bool vote)
+    {
+        tracker.votes = (uint16_t)((tracker.votes << 1) | (vote ? 1 : 0));
+        tracker.samples++;
+    }
+}
+
+/**
+ * @brief Учёт голоса очередного кадра
+ *
+ * n и m ограничиваются диапазоном 1 <= n <= m <= OCCUPANCY_MAX_WINDOW;
+ * при n = m = 1 автомат повторяет прежнее поведение по одному кадру.
+ * @param present Кадр и датчик расстояния подтверждают наличие автомобиля
+ * @return Событие прибытия или отъезда, если оно подтверждено этим голосом
+ */
+OccupancyEvent occupancyUpdate(OccupancyTracker &tracker, bool present, int n, int m)
+{
+    if (m < 1) m = 1;
+    if (m > OCCUPANCY_MAX_WINDOW) m = OCCUPANCY_MAX_WINDOW;
+    if (n < 1) n = 1;
+    if (n > m) n = m;
+
+    switch (tracker.state)
+    {
+    case ZONE_EMPTY:
+        if (!present)
+            return OCCUPANCY_NONE;
+        enter(tracker, ZONE_ARRIVING);
+        // fall through
+    case ZONE_ARRIVING:
+        record(tracker, present);
+        if (countVotes(tracker.votes) >= n)
+        {
+            enter(tracker, ZONE_OCCUPIED);
+            return OCCUPANCY_ARRIVED;
+        }
+        if (tracker.samples >= m)
+            enter(tracker, ZONE_EMPTY);
+        return OCCUPANCY_NONE;
+
+    case ZONE_OCCUPIED:
+        if (present)
+            return OCCUPANCY_NONE;
+        enter(tracker, ZONE_LEAVING);
+        // fall through
+    case ZONE_LEAVING:
+        record(tracker, present);
+        if (tracker.samples - countVotes(tracker.votes) >= n)
+        {
+            enter(tracker, ZONE_EMPTY);
+            return OCCUPANCY_DEPARTED;
+        }
+        if (tracker.samples >= m)
+            enter(tracker, ZONE_OCCUPIED);
+        return OCCUPANCY_NONE;
+    }
+
+    return OCCUPANCY_NONE;
+}
+
+/**
+ * @brief Сброс автомата в состояние EMPTY
+ */
+void occupancyReset(OccupancyTracker &tracker)
+{
+    enter(tracker, ZONE_EMPTY);
+}
+
+/**
+ * @brief Занята ли зона (OCCUPIED или LEAVING)
+ */
+bool occupancyIsOccupied(const OccupancyTracker &tracker)
+{
+    return tracker.state == ZONE_OCCUPIED || tracker.state == ZONE_LEAVING;
+}
+
+/**
+ * @brief Название состояния для журнала и веб-интерфейса
+ */
+const char *occupancyStateName(OccupancyState state)
+{
+    switch (state)
+    {
+    case ZONE_EMPTY:
+        return "EMPTY";
+    case ZONE_ARRIVING:
+        return "ARRIVING";
+    case ZONE_OCCUPIED:
+        return "OCCUPIED";
+    case ZONE_LEAVING:
+        return "LEAVING";
+    }
+    return "UNKNOWN";
+}
\ No newline at end of file
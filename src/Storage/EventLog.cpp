@@ -0,0 +1,399 @@
+/**
+ * @file EventLog.cpp
+ * @brief Реализация журнала событий детекции
+ */
+
+#include "Storage/EventLog.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Utils/Checksum.hpp"
+#include <SD_MMC.h>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+
+// Внешние объявления
+extern bool sd_initialized;
+
+EventLogStats eventLogStats;
+
+// Файл открыт на дозапись задачей записи; чтение - отдельным дескриптором
+static File logFile;
+static std::mutex logLock;
+static uint8_t recordBuffer[EVENT_RECORD_SIZE];
+static uint32_t unsynced = 0;
+static uint32_t syncedAt = 0;
+
+/**
+ * @brief Чтение заголовка записи; вызывается под logLock
+ */
+static bool readHeader(File &file, uint32_t index, EventRecordHeader &header)
+{
+    if (!file.seek((size_t)index * EVENT_RECORD_SIZE))
+        return false;
+    if (file.read((uint8_t *)&header, sizeof(header)) != sizeof(header))
+        return false;
+    return header.magic == EVENT_RECORD_MAGIC && header.length <= EVENT_PAYLOAD_MAX;
+}
+
+/**
+ * @brief Чтение записи с проверкой суммы; вызывается под logLock
+ */
+static bool readRecord(File &file, uint32_t index, uint32_t &id, String &json)
+{
+    EventRecordHeader header;
+    if (!readHeader(file, index, header))
+        return false;
+
+    if (file.read(recordBuffer, header.length) != header.length ||
+        fletcher16(recordBuffer, header.length) != header.checksum)
+        return false;
+
+    recordBuffer[header.length] = 0;
+    id = header.id;
+    json = (const char *)recordBuffer;
+    return true;
+}
+
+/**
+ * @brief Дескриптор для чтения; буферы дозаписи сбрасываются, чтобы
+ * чтение видело последние записи. Вызывается под logLock
+ */
+static File openForRead()
+{
+    if (logFile)
+        logFile.flush();
+    return SD_MMC.open(EVENT_LOG_PATH, FILE_READ);
+}
+
+/**
+ * @brief Первая запись с номером не меньше id; вызывается под logLock
+ */
+static uint32_t lowerBound(File &file, uint32_t id)
+{
+    uint32_t lo = 0, hi = eventLogStats.records;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        EventRecordHeader header;
+        if (readHeader(file, mid, header) && header.id < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Открытие журнала и восстановление после оборванной записи;
+ * вызывается под logLock
+ */
+static bool openLog()
+{
+    // Сжатие прервано между удалением журнала и переименованием копии
+    if (!SD_MMC.exists(EVENT_LOG_PATH) && SD_MMC.exists(EVENT_LOG_TEMP_PATH))
+        SD_MMC.rename(EVENT_LOG_TEMP_PATH, EVENT_LOG_PATH);
+
+    if (!SD_MMC.exists(EVENT_LOG_PATH))
+    {
+        File created = SD_MMC.open(EVENT_LOG_PATH, FILE_WRITE);
+        if (!created)
+            return false;
+        created.close();
+    }
+
+    logFile = SD_MMC.open(EVENT_LOG_PATH, "r+");
+    if (!logFile)
+    {
+        Serial.println("Failed to open event log");
+        return false;
+    }
+
+    EventLogStats &stats = eventLogStats;
+    stats.records = logFile.size() / EVENT_RECORD_SIZE;
+
+    uint32_t id;
+    String json;
+    while (stats.records > 0 && !readRecord(logFile, stats.records - 1, id, json))
+        stats.records--;
+
+    EventRecordHeader header;
+    stats.firstId = stats.records && readHeader(logFile, 0, header) ? header.id : 0;
+    stats.lastId = stats.records ? id : 0;
+    syncedAt = millis();
+
+    return true;
+}
+
+/**
+ * @brief Открытие журнала
+ *
+ * Число записей определяется по размеру файла; неполная или испорченная
+ * последняя запись перезаписывается следующей.
+ */
+bool eventLogOpen()
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    if (!sd_initialized || !openLog())
+        return false;
+
+    const EventLogStats &stats = eventLogStats;
+    Serial.printf("Event log: %u records, ids %u..%u\n", stats.records, stats.firstId, stats.lastId);
+    return true;
+}
+
+/**
+ * @brief Дозапись события
+ *
+ * Номер должен быть больше последнего в журнале, иначе поиск по номеру
+ * перестанет работать.
+ */
+bool eventLogAppend(uint32_t id, const String &json)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    EventLogStats &stats = eventLogStats;
+    if (!logFile || json.length() > EVENT_PAYLOAD_MAX || (stats.records && id <= stats.lastId))
+        return false;
+
+    EventRecordHeader header;
+    header.magic = EVENT_RECORD_MAGIC;
+    header.id = id;
+    header.length = json.length();
+    header.checksum = fletcher16((const uint8_t *)json.c_str(), json.length());
+    header.reserved = 0;
+
+    memset(recordBuffer, '\n', sizeof(recordBuffer));
+    memcpy(recordBuffer, &header, sizeof(header));
+    memcpy(recordBuffer + sizeof(header), json.c_str(), json.length());
+
+    if (!logFile.seek((size_t)stats.records * EVENT_RECORD_SIZE) ||
+        logFile.write(recordBuffer, EVENT_RECORD_SIZE) != EVENT_RECORD_SIZE)
+    {
+        Serial.println("Event log write failed");
+        return false;
+    }
+
+    if (stats.records == 0)
+        stats.firstId = id;
+    stats.records++;
+    stats.lastId = id;
+    stats.appended++;
+
+    if (++unsynced >= EVENT_LOG_SYNC_RECORDS)
+    {
+        logFile.flush();
+        unsynced = 0;
+        syncedAt = millis();
+        stats.syncs++;
+    }
+    return true;
+}
+
+/**
+ * @brief Сброс дозаписанных событий на карту
+ * @param force Сбросить сразу, иначе - по истечении EVENT_LOG_SYNC_MS
+ */
+void eventLogSync(bool force)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    if (!logFile || unsynced == 0)
+        return;
+    if (!force && millis() - syncedAt < EVENT_LOG_SYNC_MS)
+        return;
+
+    logFile.flush();
+    unsynced = 0;
+    syncedAt = millis();
+    eventLogStats.syncs++;
+}
+
+/**
+ * @brief Чтение записи по порядковому номеру в журнале
+ */
+bool eventLogRead(uint32_t index, uint32_t &id, String &json)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    if (index >= eventLogStats.records)
+        return false;
+
+    File file = openForRead();
+    bool ok = file && readRecord(file, index, id, json);
+    file.close();
+    return ok;
+}
+
+/**
+ * @brief Поиск события по номеру
+ */
+bool eventLogFind(uint32_t id, String &json)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    File file = openForRead();
+    if (!file)
+        return false;
+
+    uint32_t found;
+    uint32_t index = lowerBound(file, id);
+    bool ok = id >= eventLogStats.floorId && index < eventLogStats.records && readRecord(file, index, found, json) && found == id;
+    file.close();
+    return ok;
+}
+
+/**
+ * @brief Установка позиции чтения на первое событие с номером не меньше id
+ */
+void eventLogSeek(EventLogCursor &cursor, uint32_t id)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    File file = openForRead();
+    cursor.index = file ? lowerBound(file, max(id, eventLogStats.floorId)) : eventLogStats.records;
+    file.close();
+}
+
+/**
+ * @brief Следующее событие по позиции чтения
+ *
+ * Испорченные записи пропускаются.
+ * @return false - событий больше нет
+ */
+bool eventLogNext(EventLogCursor &cursor, uint32_t &id, String &json)
+{
+    while (cursor.index < eventLogStats.records)
+    {
+        if (eventLogRead(cursor.index++, id, json))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Однократный перенос метаданных из отдельных файлов car_<номер>.json
+ *
+ * Перенесённые файлы удаляются, поэтому при следующей загрузке переносить
+ * нечего. Файл, событие которого уже есть в журнале (перенос прервался
+ * между записью и удалением), тоже удаляется; файлы с меньшим номером,
+ * чем последний в журнале, остаются на месте.
+ * @return Число перенесённых событий
+ */
+int eventLogImportLegacy()
+{
+    if (!sd_initialized || !logFile)
+        return 0;
+
+    struct LegacyEvent
+    {
+        uint32_t id;
+        String name;
+    };
+    std::vector<LegacyEvent> events;
+    File root = SD_MMC.open("/");
+    if (!root)
+        return 0;
+
+    File file = root.openNextFile();
+    while (file)
+    {
+        String name = file.name();
+        if (name.startsWith("/"))
+            name = name.substring(1);
+        // Имя метаданных совпадает с именем фотографии, кроме расширения
+        uint32_t id;
+        if (!file.isDirectory() && name.endsWith(".json") &&
+            photoIdFromName(name.substring(0, name.length() - 5) + ".jpg", id))
+            events.push_back({id, name});
+        file.close();
+        file = root.openNextFile();
+    }
+    root.close();
+
+    if (events.empty())
+        return 0;
+
+    // Старые имена без ведущих нулей (car_2, car_10, car_100): строковая
+    // сортировка поставила бы car_100 перед car_11, и журнал отверг бы
+    // все меньшие номера после него
+    std::sort(events.begin(), events.end(), [](const LegacyEvent &a, const LegacyEvent &b)
+              { return a.id < b.id; });
+
+    int imported = 0;
+    for (const LegacyEvent &event : events)
+    {
+        String path = "/" + event.name;
+        uint32_t id = event.id;
+
+        File legacy = SD_MMC.open(path.c_str(), FILE_READ);
+        if (!legacy)
+            continue;
+        String json = legacy.readString();
+        legacy.close();
+
+        if (!eventLogAppend(id, json))
+        {
+            String logged;
+            if (eventLogFind(id, logged))
+                SD_MMC.remove(path.c_str());
+            else
+                Serial.println("Not imported: " + path);
+            continue;
+        }
+        SD_MMC.remove(path.c_str());
+        imported++;
+    }
+
+    eventLogSync(true);
+    eventLogStats.imported += imported;
+    Serial.printf("Imported %d legacy event files\n", imported);
+    return imported;
+}
+
+/**
+ * @brief Скрытие событий с номером меньше floorId
+ *
+ * Удалённые события перестают находиться сразу; когда их набирается
+ * EVENT_LOG_COMPACT_RECORDS, оставшиеся записи копируются в новый файл,
+ * который заменяет журнал.
+ */
+void eventLogTrim(uint32_t floorId)
+{
+    std::lock_guard<std::mutex> guard(logLock);
+    EventLogStats &stats = eventLogStats;
+    stats.floorId = max(stats.floorId, floorId);
+    if (!logFile)
+        return;
+
+    logFile.flush();
+    uint32_t first = lowerBound(logFile, stats.floorId);
+    if (first < EVENT_LOG_COMPACT_RECORDS)
+        return;
+
+    // Копия без удалённых событий; журнал заменяется только целой копией
+    File temp = SD_MMC.open(EVENT_LOG_TEMP_PATH, FILE_WRITE);
+    if (!temp)
+        return;
+
+    bool ok = true;
+    for (uint32_t i = first; i < stats.records && ok; i++)
+    {
+        ok = logFile.seek((size_t)i * EVENT_RECORD_SIZE) &&
+             logFile.read(recordBuffer, EVENT_RECORD_SIZE) == EVENT_RECORD_SIZE &&
+             temp.write(recordBuffer, EVENT_RECORD_SIZE) == EVENT_RECORD_SIZE;
+    }
+    temp.close();
+
+    if (!ok)
+    {
+        SD_MMC.remove(EVENT_LOG_TEMP_PATH);
+        Serial.println("Event log compaction failed");
+        return;
+    }
+
+    // Сбой между удалением и переименованием оставляет только копию,
+    // openLog() при следующем запуске переименует её
+    logFile.close();
+    SD_MMC.remove(EVENT_LOG_PATH);
+    SD_MMC.rename(EVENT_LOG_TEMP_PATH, EVENT_LOG_PATH);
+    openLog();
+    unsynced = 0;
+    stats.compactions++;
+    Serial.printf("Event log compacted: %u records dropped\n", first);
+}
\ No newline at end of file
@@ -0,0 +1,296 @@
+/**
+ * @file PhotoArchive.cpp
+ * @brief Реализация раскладки архива фотографий
+ */
+
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/PhotoIndex.hpp"
+#include "Camera/JpegHistory.hpp"
+#include <SD_MMC.h>
+#include <algorithm>
+
+// Внешние объявления
+extern bool sd_initialized;
+
+// Последний созданный каталог: задача записи не проверяет его повторно
+static String preparedBucket;
+
+/**
+ * @brief Номер с ведущими нулями
+ */
+static String zeroPad(uint32_t value, unsigned int width)
+{
+    String text = String(value);
+    while (text.length() < width)
+        text = "0" + text;
+    return text;
+}
+
+/**
+ * @brief Имя файла без каталога
+ *
+ * File::name() возвращает полный путь или только имя в зависимости от
+ * версии ядра.
+ */
+static String baseName(const String &path)
+{
+    return path.substring(path.lastIndexOf('/') + 1);
+}
+
+/**
+ * @brief Каталог фотографий с заданным номером
+ */
+String photoBucketPath(uint32_t id)
+{
+    return String(PHOTO_ARCHIVE_ROOT) + "/" + zeroPad(id / PHOTO_BUCKET_SIZE, 3);
+}
+
+/**
+ * @brief Путь фотографии по номеру
+ */
+String photoPath(uint32_t id)
+{
+    return photoBucketPath(id) + "/car_" + zeroPad(id, 5) + ".jpg";
+}
+
+/**
+ * @brief Имя фотографии для веб-интерфейса
+ */
+String photoName(uint32_t id)
+{
+    return "car_" + zeroPad(id, 5) + ".jpg";
+}
+
+/**
+ * @brief Путь кадра истории до срабатывания события с номером id
+ */
+String photoPrePath(uint32_t id, int index)
+{
+    return photoBucketPath(id) + "/car_" + zeroPad(id, 5) + "_pre" + String(index) + ".jpg";
+}
+
+/**
+ * @brief Номер фотографии из имени car_NNNNN.jpg или car_NNNNN_pre<k>.jpg
+ */
+bool photoIdFromName(const String &name, uint32_t &id)
+{
+    if (!name.startsWith("car_") || !name.endsWith(".jpg"))
+        return false;
+
+    unsigned int end = 4;
+    while (end < name.length() && isDigit(name[end]))
+        end++;
+    if (end == 4)
+        return false;
+
+    id = name.substring(4, end).toInt();
+    return true;
+}
+
+/**
+ * @brief Полный путь файла архива по имени из веб-интерфейса
+ *
+ * Принимаются только имена фотографий архива, поэтому параметр запроса
+ * не может указать на другой файл карты.
+ * @return Путь или пустая строка
+ */
+String photoResolve(const String &name)
+{
+    String base = baseName(name);
+    uint32_t id;
+    if (!photoIdFromName(base, id))
+        return String();
+    return photoBucketPath(id) + "/" + base;
+}
+
+/**
+ * @brief Создание каталога архива для пути файла
+ */
+bool photoArchiveEnsureDir(const String &path)
+{
+    String bucket = path.substring(0, path.lastIndexOf('/'));
+    if (bucket.length() == 0 || bucket == preparedBucket)
+        return true;
+
+    if (!SD_MMC.exists(PHOTO_ARCHIVE_ROOT) && !SD_MMC.mkdir(PHOTO_ARCHIVE_ROOT))
+        return false;
+    if (!SD_MMC.exists(bucket.c_str()) && !SD_MMC.mkdir(bucket.c_str()))
+        return false;
+
+    preparedBucket = bucket;
+    return true;
+}
+
+/**
+ * @brief Номер для сортировки: номер каталога или номер фотографии
+ *
+ * Имена без номера получают 0, кадры истории - номер своей фотографии.
+ */
+static uint32_t sortKey(const String &name, bool directory)
+{
+    if (directory)
+        return name.toInt();
+
+    uint32_t id = 0;
+    photoIdFromName(name, id);
+    return id;
+}
+
+/**
+ * @brief Имена файлов каталога, отсортированные по убыванию номера
+ *
+ * Сортировка по номеру, а не по строке: номера в именах могут быть
+ * разной ширины (car_100 и car_99999, каталог 1000 после 999).
+ */
+static std::vector<String> listDirectory(const String &path, bool directories)
+{
+    std::vector<std::pair<uint32_t, String>> entries;
+    std::vector<String> names;
+    File dir = SD_MMC.open(path.c_str());
+    if (!dir || !dir.isDirectory())
+        return names;
+
+    File file = dir.openNextFile();
+    while (file)
+    {
+        if (file.isDirectory() == directories)
+        {
+            String name = baseName(file.name());
+            entries.push_back(std::make_pair(sortKey(name, directories), name));
+        }
+        file.close();
+        file = dir.openNextFile();
+    }
+    dir.close();
+
+    std::sort(entries.begin(), entries.end(), [](const std::pair<uint32_t, String> &a,
+                                                 const std::pair<uint32_t, String> &b)
+              { return a.first != b.first ? a.first > b.first : a.second > b.second; });
+    for (const auto &entry : entries)
+        names.push_back(entry.second);
+    return names;
+}
+
+/**
+ * @brief Номер самой старой фотографии архива
+ *
+ * Читается только первый непустой каталог.
+ */
+bool photoArchiveOldest(uint32_t &id)
+{
+    if (!sd_initialized)
+        return false;
+
+    std::vector<String> buckets = listDirectory(PHOTO_ARCHIVE_ROOT, true);
+    for (auto bucket = buckets.rbegin(); bucket != buckets.rend(); ++bucket)
+    {
+        std::vector<String> names = listDirectory(String(PHOTO_ARCHIVE_ROOT) + "/" + *bucket, false);
+        for (auto name = names.rbegin(); name != names.rend(); ++name)
+        {
+            if (photoIdFromName(*name, id))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Удаление фотографии, её кадров истории и записи индекса
+ */
+bool photoArchiveDelete(const String &name)
+{
+    String path = photoResolve(name);
+    if (path.length() == 0 || !SD_MMC.exists(path.c_str()))
+        return false;
+
+    SD_MMC.remove(path.c_str());
+
+    uint32_t id;
+    photoIdFromName(baseName(path), id);
+    photoIndexRemove(id);
+
+    // Номера кадров истории могут идти с пропусками: кадр, не записанный
+    // на карту, не прерывает удаление следующих
+    for (int k = 0; k < JPEG_HISTORY_MAX_FRAMES; k++)
+    {
+        String pre = photoPrePath(id, k);
+        if (SD_MMC.exists(pre.c_str()))
+            SD_MMC.remove(pre.c_str());
+    }
+    return true;
+}
+
+/**
+ * @brief Путь архива для файла со старым именем
+ *
+ * Старые имена без ведущих нулей (car_12.jpg, car_12_pre3.jpg)
+ * приводятся к photoPath()/photoPrePath(), по которым файлы ищут
+ * веб-интерфейс, удаление и очистка архива.
+ */
+static String archivePathForLegacy(const String &name)
+{
+    uint32_t id;
+    if (!photoIdFromName(name, id))
+        return String();
+
+    int pre = name.indexOf("_pre");
+    if (pre < 0)
+        return photoPath(id);
+
+    String index = name.substring(pre + 4, name.length() - 4);
+    if (index.length() == 0)
+        return String();
+    for (unsigned int i = 0; i < index.length(); i++)
+    {
+        if (!isDigit(index[i]))
+            return String();
+    }
+    return photoPrePath(id, index.toInt());
+}
+
+/**
+ * @brief Однократный перенос фотографий из корня карты в каталоги архива
+ *
+ * Файлы переименовываются в имена фиксированной ширины.
+ * @return Число перенесённых файлов
+ */
+int photoArchiveMigrate()
+{
+    if (!sd_initialized)
+        return 0;
+
+    std::vector<String> names;
+    File root = SD_MMC.open("/");
+    if (!root)
+        return 0;
+
+    File file = root.openNextFile();
+    while (file)
+    {
+        String name = baseName(file.name());
+        uint32_t id;
+        if (!file.isDirectory() && photoIdFromName(name, id))
+            names.push_back(name);
+        file.close();
+        file = root.openNextFile();
+    }
+    root.close();
+
+    int moved = 0;
+    for (const String &name : names)
+    {
+        String from = "/" + name;
+        String to = archivePathForLegacy(name);
+        if (to.length() == 0 || SD_MMC.exists(to.c_str()) || !photoArchiveEnsureDir(to) ||
+            !SD_MMC.rename(from.c_str(), to.c_str()))
+        {
+            Serial.println("Not migrated: " + from);
+            continue;
+        }
+        moved++;
+    }
+
+    if (moved)
+        Serial.printf("Migrated %d photos to %s\n", moved, PHOTO_ARCHIVE_ROOT);
+    return moved;
+}
\ No newline at end of file
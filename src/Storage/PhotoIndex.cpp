@@ -0,0 +1,402 @@
+/**
+ * @file PhotoIndex.cpp
+ * @brief Реализация индекса фотографий
+ */
+
+#include "Storage/PhotoIndex.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/EventLog.hpp"
+#include "Utils/Checksum.hpp"
+#include <ArduinoJson.h>
+#include <SD_MMC.h>
+#include <math.h>
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+// Внешние объявления
+extern bool sd_initialized;
+
+/**
+ * @brief Заголовок файла индекса
+ */
+struct PhotoIndexHeader
+{
+    uint32_t magic;
+    uint16_t entrySize;
+    uint16_t reserved;
+    uint32_t live; // неудалённых записей; сверяется при открытии не полностью
+};
+
+static_assert(sizeof(PhotoIndexEntry) == 20, "PhotoIndexEntry layout is part of the file format");
+
+PhotoIndexStats photoIndexStats;
+
+// Индекс пишет задача записи, читает и помечает удаление веб-интерфейс
+static File indexFile;
+static std::mutex indexLock;
+static uint32_t firstLive = 0; // первая неудалённая запись
+static uint32_t lastId = 0;
+
+/**
+ * @brief Смещение записи в файле
+ */
+static size_t entryOffset(uint32_t index)
+{
+    return sizeof(PhotoIndexHeader) + (size_t)index * sizeof(PhotoIndexEntry);
+}
+
+/**
+ * @brief Контрольная сумма полей записи
+ */
+static uint16_t entryChecksum(const PhotoIndexEntry &entry)
+{
+    return fletcher16((const uint8_t *)&entry, offsetof(PhotoIndexEntry, checksum));
+}
+
+/**
+ * @brief Чтение записи с проверкой суммы; вызывается под indexLock
+ */
+static bool readEntry(File &file, uint32_t index, PhotoIndexEntry &entry)
+{
+    return file.seek(entryOffset(index)) &&
+           file.read((uint8_t *)&entry, sizeof(entry)) == sizeof(entry) &&
+           entry.checksum == entryChecksum(entry);
+}
+
+/**
+ * @brief Запись элемента; вызывается под indexLock
+ */
+static bool writeEntry(File &file, uint32_t index, PhotoIndexEntry &entry)
+{
+    entry.checksum = entryChecksum(entry);
+    return file.seek(entryOffset(index)) &&
+           file.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+}
+
+/**
+ * @brief Запись заголовка; вызывается под indexLock
+ */
+static bool writeHeader(File &file, uint32_t live)
+{
+    PhotoIndexHeader header = {PHOTO_INDEX_MAGIC, sizeof(PhotoIndexEntry), 0, live};
+    return file.seek(0) && file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+}
+
+/**
+ * @brief Двоичный поиск записи по номеру; вызывается под indexLock
+ * @return Индекс записи или photoIndexStats.entries, если её нет
+ */
+static uint32_t findEntry(uint32_t id, PhotoIndexEntry &entry)
+{
+    uint32_t lo = 0, hi = photoIndexStats.entries;
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!readEntry(indexFile, mid, entry))
+            return photoIndexStats.entries;
+        if (entry.id == id)
+            return mid;
+        if (entry.id < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return photoIndexStats.entries;
+}
+
+/**
+ * @brief Открытие файла индекса с проверкой; вызывается под indexLock
+ *
+ * Неполная или испорченная последняя запись отбрасывается и будет
+ * перезаписана; неверный заголовок означает, что индекс нужно перестроить.
+ */
+static bool openIndex()
+{
+    indexFile = SD_MMC.open(PHOTO_INDEX_PATH, "r+");
+    if (!indexFile)
+        return false;
+
+    PhotoIndexHeader header;
+    if (indexFile.read((uint8_t *)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != PHOTO_INDEX_MAGIC || header.entrySize != sizeof(PhotoIndexEntry))
+    {
+        indexFile.close();
+        return false;
+    }
+
+    PhotoIndexStats &stats = photoIndexStats;
+    stats.entries = (indexFile.size() - sizeof(PhotoIndexHeader)) / sizeof(PhotoIndexEntry);
+    stats.live = header.live;
+
+    PhotoIndexEntry entry;
+    while (stats.entries > 0 && !readEntry(indexFile, stats.entries - 1, entry))
+        stats.entries--;
+    lastId = stats.entries ? entry.id : 0;
+
+    // Удалённые записи в начале ограничены порогом сжатия
+    firstLive = 0;
+    while (firstLive < stats.entries && readEntry(indexFile, firstLive, entry) &&
+           (entry.flags & PHOTO_INDEX_DELETED))
+        firstLive++;
+
+    stats.live = min(stats.live, stats.entries - firstLive);
+    return true;
+}
+
+/**
+ * @brief Доля 0..1 в тысячных для записи индекса
+ *
+ * Значение вне диапазона или NaN (например, из повреждённого журнала)
+ * ограничивается, чтобы не переполнить uint16_t.
+ */
+uint16_t photoIndexPermille(float ratio)
+{
+    if (!(ratio > 0.0f))
+        return 0;
+    return (uint16_t)lroundf(constrain(ratio, 0.0f, 1.0f) * 1000.0f);
+}
+
+/**
+ * @brief Метрики фотографии из журнала событий
+ */
+static void fillFromEvent(PhotoIndexEntry &entry)
+{
+    String json;
+    if (!eventLogFind(entry.id, json))
+        return;
+
+    DynamicJsonDocument doc(EVENT_RECORD_SIZE);
+    if (deserializeJson(doc, json))
+        return;
+
+    entry.uptime = doc["uptime_ms"] | 0;
+    entry.distance = doc["distance"] | 0;
+    entry.darkPermille = photoIndexPermille(doc["darkRatio"] | 0.0f);
+    entry.zone = doc["zone"] | 0;
+}
+
+/**
+ * @brief Номер каталога архива по его имени или пути
+ */
+static uint32_t bucketNumber(const String &path)
+{
+    return path.substring(path.lastIndexOf('/') + 1).toInt();
+}
+
+/**
+ * @brief Перестроение индекса по каталогам архива
+ *
+ * Индекс пишется во временный файл и заменяет старый только целиком.
+ * Метрики берутся из журнала событий. Вызывается под indexLock.
+ */
+static bool rebuildIndex()
+{
+    if (indexFile)
+        indexFile.close();
+
+    File temp = SD_MMC.open(PHOTO_INDEX_TEMP_PATH, FILE_WRITE);
+    if (!temp)
+        return false;
+
+    std::vector<String> buckets;
+    File root = SD_MMC.open(PHOTO_ARCHIVE_ROOT);
+    if (root && root.isDirectory())
+    {
+        File dir = root.openNextFile();
+        while (dir)
+        {
+            if (dir.isDirectory())
+                buckets.push_back(dir.name());
+            dir.close();
+            dir = root.openNextFile();
+        }
+        root.close();
+    }
+    // По номеру каталога, а не по строке: каталог 1000 идёт после 999
+    std::sort(buckets.begin(), buckets.end(), [](const String &a, const String &b)
+              { return bucketNumber(a) < bucketNumber(b); });
+
+    writeHeader(temp, 0);
+    uint32_t count = 0;
+    for (String bucket : buckets)
+    {
+        if (!bucket.startsWith("/"))
+            bucket = String(PHOTO_ARCHIVE_ROOT) + "/" + bucket;
+
+        // Размер берётся из записи каталога, файлы не открываются
+        std::vector<PhotoIndexEntry> entries;
+        File dir = SD_MMC.open(bucket.c_str());
+        File file = dir ? dir.openNextFile() : File();
+        while (file)
+        {
+            String name = file.name();
+            name = name.substring(name.lastIndexOf('/') + 1);
+            PhotoIndexEntry entry;
+            if (!file.isDirectory() && name.indexOf("_pre") < 0 && photoIdFromName(name, entry.id))
+            {
+                entry.size = file.size();
+                entries.push_back(entry);
+            }
+            file.close();
+            file = dir.openNextFile();
+        }
+        dir.close();
+
+        std::sort(entries.begin(), entries.end(), [](const PhotoIndexEntry &a, const PhotoIndexEntry &b)
+                  { return a.id < b.id; });
+        for (PhotoIndexEntry &entry : entries)
+        {
+            fillFromEvent(entry);
+            entry.checksum = entryChecksum(entry);
+            temp.write((const uint8_t *)&entry, sizeof(entry));
+            count++;
+        }
+    }
+
+    writeHeader(temp, count);
+    temp.close();
+
+    SD_MMC.remove(PHOTO_INDEX_PATH);
+    if (!SD_MMC.rename(PHOTO_INDEX_TEMP_PATH, PHOTO_INDEX_PATH))
+        return false;
+
+    photoIndexStats.rebuilds++;
+    Serial.printf("Photo index rebuilt: %u photos\n", count);
+    return openIndex();
+}
+
+/**
+ * @brief Перезапись индекса без удалённых записей в начале;
+ * вызывается под indexLock
+ */
+static void compactIndex()
+{
+    File temp = SD_MMC.open(PHOTO_INDEX_TEMP_PATH, FILE_WRITE);
+    if (!temp)
+        return;
+
+    bool ok = writeHeader(temp, photoIndexStats.live);
+    PhotoIndexEntry entry;
+    for (uint32_t i = firstLive; i < photoIndexStats.entries && ok; i++)
+    {
+        ok = indexFile.seek(entryOffset(i)) &&
+             indexFile.read((uint8_t *)&entry, sizeof(entry)) == sizeof(entry) &&
+             temp.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+    }
+    temp.close();
+
+    if (!ok)
+    {
+        SD_MMC.remove(PHOTO_INDEX_TEMP_PATH);
+        return;
+    }
+
+    uint32_t dropped = firstLive;
+    indexFile.close();
+    SD_MMC.remove(PHOTO_INDEX_PATH);
+    SD_MMC.rename(PHOTO_INDEX_TEMP_PATH, PHOTO_INDEX_PATH);
+    openIndex();
+    photoIndexStats.compactions++;
+    Serial.printf("Photo index compacted: %u entries dropped\n", dropped);
+}
+
+/**
+ * @brief Открытие индекса; отсутствующий или испорченный перестраивается
+ */
+bool photoIndexOpen()
+{
+    std::lock_guard<std::mutex> guard(indexLock);
+    if (!sd_initialized)
+        return false;
+
+    // Замена прервана между удалением индекса и переименованием копии
+    if (!SD_MMC.exists(PHOTO_INDEX_PATH) && SD_MMC.exists(PHOTO_INDEX_TEMP_PATH))
+        SD_MMC.rename(PHOTO_INDEX_TEMP_PATH, PHOTO_INDEX_PATH);
+
+    if (!openIndex() && !rebuildIndex())
+    {
+        Serial.println("Photo index unavailable");
+        return false;
+    }
+
+    Serial.printf("Photo index: %u photos\n", photoIndexStats.live);
+    return true;
+}
+
+/**
+ * @brief Добавление сохранённой фотографии
+ *
+ * Номер должен быть больше последнего в индексе.
+ */
+bool photoIndexAppend(PhotoIndexEntry &entry)
+{
+    std::lock_guard<std::mutex> guard(indexLock);
+    PhotoIndexStats &stats = photoIndexStats;
+    if (!indexFile || (stats.entries && entry.id <= lastId))
+        return false;
+
+    entry.flags = 0;
+    if (!writeEntry(indexFile, stats.entries, entry))
+        return false;
+
+    stats.entries++;
+    stats.live++;
+    lastId = entry.id;
+    writeHeader(indexFile, stats.live);
+    indexFile.flush();
+    return true;
+}
+
+/**
+ * @brief Пометка фотографии удалённой
+ */
+bool photoIndexRemove(uint32_t id)
+{
+    std::lock_guard<std::mutex> guard(indexLock);
+    PhotoIndexStats &stats = photoIndexStats;
+    if (!indexFile)
+        return false;
+
+    PhotoIndexEntry entry;
+    uint32_t index = findEntry(id, entry);
+    if (index >= stats.entries || (entry.flags & PHOTO_INDEX_DELETED))
+        return false;
+
+    entry.flags |= PHOTO_INDEX_DELETED;
+    if (!writeEntry(indexFile, index, entry))
+        return false;
+
+    if (stats.live)
+        stats.live--;
+    writeHeader(indexFile, stats.live);
+    indexFile.flush();
+
+    while (firstLive < stats.entries && readEntry(indexFile, firstLive, entry) &&
+           (entry.flags & PHOTO_INDEX_DELETED))
+        firstLive++;
+    if (firstLive >= PHOTO_INDEX_COMPACT)
+        compactIndex();
+    return true;
+}
+
+/**
+ * @brief Новейшие неудалённые фотографии, от последней к первой
+ * @return Число записей в entries
+ */
+int photoIndexNewest(PhotoIndexEntry *entries, int limit)
+{
+    std::lock_guard<std::mutex> guard(indexLock);
+    if (!indexFile)
+        return 0;
+
+    int count = 0;
+    for (uint32_t i = photoIndexStats.entries; i > firstLive && count < limit; i--)
+    {
+        PhotoIndexEntry &entry = entries[count];
+        if (readEntry(indexFile, i - 1, entry) && !(entry.flags & PHOTO_INDEX_DELETED))
+            count++;
+    }
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+/**
+ * @file Retention.cpp
+ * @brief Реализация ограничения архива фотографий
+ */
+
+#include "Storage/Retention.hpp"
+#include "Storage/RetentionRange.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/EventLog.hpp"
+#include "Config/Config.hpp"
+#include <Preferences.h>
+#include <SD_MMC.h>
+
+// Внешние объявления
+extern bool sd_initialized;
+extern Preferences preferences;
+extern int photoNumber;
+
+RetentionStats retentionStats;
+
+/**
+ * @brief Свободное место на карте, процентов
+ */
+static int freePercent()
+{
+    uint64_t total = SD_MMC.totalBytes();
+    if (total == 0)
+        return 100;
+    return (int)((total - SD_MMC.usedBytes()) * 100 / total);
+}
+
+/**
+ * @brief Нужно ли удалить ещё одну фотографию
+ *
+ * Свободное место проверяется, только если число фотографий в пределах
+ * max_files.
+ */
+static bool overLimit(uint32_t newest)
+{
+    uint32_t oldest = retentionStats.oldestId;
+    if (retentionOverCount(oldest, newest, settings.max_files))
+        return true;
+
+    if (retentionMayFreeSpace(oldest, newest, settings.min_free_percent))
+    {
+        retentionStats.freePercent = freePercent();
+        return retentionStats.freePercent < settings.min_free_percent;
+    }
+    return false;
+}
+
+/**
+ * @brief Загрузка номера самой старой фотографии
+ *
+ * Номер хранится в NVS; при первом запуске он берётся из первого
+ * каталога архива. Записи журнала событий старше него скрываются.
+ */
+void setupRetention()
+{
+    int oldest = preferences.getInt("oldest", 0);
+    if (oldest <= 0)
+    {
+        uint32_t id;
+        oldest = photoArchiveOldest(id) ? (int)id : photoNumber;
+        preferences.putInt("oldest", oldest);
+    }
+
+    retentionStats.oldestId = oldest;
+    eventLogTrim(retentionStats.oldestId);
+    Serial.printf("Retention: oldest photo %d, next %d\n", oldest, photoNumber);
+}
+
+/**
+ * @brief Удаление самых старых фотографий сверх max_files или при
+ * свободном месте меньше min_free_percent
+ *
+ * Вызывается задачей записи; за вызов удаляется не больше RETENTION_BATCH
+ * фотографий, остаток - при следующем вызове.
+ * @return Число удалённых фотографий
+ */
+int retentionEnforce()
+{
+    if (!sd_initialized || photoNumber <= 1)
+        return 0;
+
+    uint32_t newest = photoNumber - 1;
+    uint32_t start = retentionStats.oldestId;
+    int evicted = 0;
+    for (int i = 0; i < RETENTION_BATCH && overLimit(newest); i++)
+    {
+        String name = photoPath(retentionStats.oldestId);
+        if (photoArchiveDelete(name))
+        {
+            retentionStats.evicted++;
+            evicted++;
+        }
+        else
+        {
+            retentionStats.missing++;
+        }
+        retentionStats.oldestId++;
+    }
+
+    if (retentionStats.oldestId != start)
+    {
+        preferences.putInt("oldest", retentionStats.oldestId);
+        eventLogTrim(retentionStats.oldestId);
+    }
+    if (evicted)
+        Serial.printf("Retention: evicted %d photos, oldest now %u\n", evicted, retentionStats.oldestId);
+    return evicted;
+}
\ No newline at end of file
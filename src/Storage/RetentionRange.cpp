@@ -0,0 +1,36 @@
+/**
+ * @file RetentionRange.cpp
+ * @brief Реализация правил ограничения архива
+ */
+
+#include "Storage/RetentionRange.hpp"
+
+/**
+ * @brief Число номеров в диапазоне, 0 - архив пуст
+ */
+uint32_t retentionRangeCount(uint32_t oldest, uint32_t newest)
+{
+    if (oldest > newest)
+        return 0;
+    return newest - oldest + 1;
+}
+
+/**
+ * @brief Превышено ли число фотографий
+ * @param maxFiles Наибольшее число фотографий, 0 - без ограничения
+ */
+bool retentionOverCount(uint32_t oldest, uint32_t newest, int maxFiles)
+{
+    return maxFiles > 0 && retentionRangeCount(oldest, newest) > (uint32_t)maxFiles;
+}
+
+/**
+ * @brief Можно ли удалить фотографию ради свободного места
+ *
+ * Последняя фотография ради свободного места не удаляется.
+ * @param minFreePercent Наименьшее свободное место, 0 - без ограничения
+ */
+bool retentionMayFreeSpace(uint32_t oldest, uint32_t newest, int minFreePercent)
+{
+    return minFreePercent > 0 && oldest < newest;
+}
\ No newline at end of file
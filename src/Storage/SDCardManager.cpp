@@ -4,6 +4,8 @@
  */
 
 #include "Storage/SDCardManager.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/PhotoIndex.hpp"
 
 // Внешние объявления
 extern bool sd_initialized;
@@ -102,6 +104,33 @@ bool savePhotoToSD(const char *filename, camera_fb_t *fb, const DynamicJsonDocum
     return success;
 }
 
+/**
+ * @brief Сохранение JPEG из памяти без файла метаданных
+ */
+bool saveJpegToSD(const String &path, const uint8_t *data, size_t len)
+{
+    if (!sd_initialized || !data || !len)
+        return false;
+
+    File file = SD_MMC.open(path.c_str(), FILE_WRITE);
+    if (!file)
+    {
+        Serial.println("Failed to open file for writing");
+        return false;
+    }
+
+    size_t written = file.write(data, len);
+    file.close();
+
+    if (written != len)
+    {
+        Serial.printf("Write failed: %zu of %zu bytes written\n", written, len);
+        return false;
+    }
+
+    return verifyFile(path, len);
+}
+
 /**
  * @brief Верификация сохраненного файла
  */
@@ -127,7 +156,7 @@ bool verifyFile(const String &path, size_t expectedSize)
 }
 
 /**
- * @brief Получение списка файлов
+ * @brief Получение списка последних фотографий архива
  */
 String listFiles()
 {
@@ -136,29 +165,19 @@ String listFiles()
 
     String fileList = "<html><head><title>Saved Photos</title></head><body>";
     fileList += "<h2>Saved Photos:</h2><ul>";
-    File root = SD_MMC.open("/");
-    
-    if (!root)
-        return "Failed to open SD root";
-    
-    File file = root.openNextFile();
-    int count = 0;
-    
-    while(file && count < 20)
+
+    PhotoIndexEntry entries[20];
+    int count = photoIndexNewest(entries, 20);
+    for (int i = 0; i < count; i++)
     {
-        if(!file.isDirectory() && String(file.name()).endsWith(".jpg"))
-        {
-            fileList += "<li>" + String(file.name()) + " (" + String(file.size()) + " bytes)</li>";
-            count++;
-        }
-        file.close();
-        file = root.openNextFile();
+        String name = photoName(entries[i].id);
+        fileList += "<li><a href='/download_photo?file=" + name + "'>" + name + "</a> (" +
+                    String(entries[i].size) + " bytes)</li>";
     }
     
     fileList += "</ul>";
     fileList += "<p><a href='/'>Back to main page</a></p>";
     fileList += "</body></html>";
-    root.close();
     
     return fileList;
 }
\ No newline at end of file
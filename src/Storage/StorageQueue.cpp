@@ -0,0 +1,87 @@
+/**
+ * @file StorageQueue.cpp
+ * @brief Реализация очереди записи
+ */
+
+#include "Storage/StorageQueue.hpp"
+#include <chrono>
+
+/**
+ * @brief Инициализация пустой очереди
+ * @param capacity Длина очереди, не больше STORAGE_QUEUE_MAX
+ */
+void storageQueueInit(StorageQueue &queue, int capacity)
+{
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (capacity > STORAGE_QUEUE_MAX)
+        capacity = STORAGE_QUEUE_MAX;
+    queue.capacity = capacity > 0 ? capacity : 0;
+    queue.first = 0;
+    queue.count = 0;
+    queue.depthMax = 0;
+}
+
+/**
+ * @brief Постановка записи в конец очереди
+ *
+ * При STORAGE_DROP_OLDEST заполненная очередь отдаёт самую старую запись
+ * в dropped, при STORAGE_BLOCK запись ждёт места до timeoutMs.
+ * @param dropped Вытесненная запись, которую освобождает вызывающий, или nullptr
+ * @return false - запись не принята, её освобождает вызывающий
+ */
+bool storageQueuePush(StorageQueue &queue, void *item, StoragePolicy policy, uint32_t timeoutMs, void *&dropped)
+{
+    std::unique_lock<std::mutex> guard(queue.lock);
+    dropped = nullptr;
+    if (queue.capacity == 0)
+        return false;
+
+    if (queue.count == queue.capacity)
+    {
+        if (policy == STORAGE_BLOCK)
+        {
+            if (!queue.changed.wait_for(guard, std::chrono::milliseconds(timeoutMs),
+                                        [&queue] { return queue.count < queue.capacity; }))
+                return false;
+        }
+        else
+        {
+            dropped = queue.items[queue.first];
+            queue.first = (queue.first + 1) % queue.capacity;
+            queue.count--;
+        }
+    }
+
+    queue.items[(queue.first + queue.count) % queue.capacity] = item;
+    queue.count++;
+    if ((uint32_t)queue.count > queue.depthMax)
+        queue.depthMax = queue.count;
+    queue.changed.notify_all();
+    return true;
+}
+
+/**
+ * @brief Самая старая запись очереди, с ожиданием до timeoutMs
+ * @return false - очередь пуста
+ */
+bool storageQueuePop(StorageQueue &queue, void *&item, uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> guard(queue.lock);
+    if (!queue.changed.wait_for(guard, std::chrono::milliseconds(timeoutMs), [&queue] { return queue.count > 0; }))
+        return false;
+
+    item = queue.items[queue.first];
+    queue.first = (queue.first + 1) % queue.capacity;
+    queue.count--;
+    queue.changed.notify_all();
+    return true;
+}
+
+/**
+ * @brief Число записей в очереди
+ */
+int storageQueueCount(StorageQueue &queue)
+{
+    std::lock_guard<std::mutex> guard(queue.lock);
+    return queue.count;
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+/**
+ * @file StorageWriter.cpp
+ * @brief Реализация фоновой записи на SD карту
+ */
+
+#include "Storage/StorageWriter.hpp"
+#include "Storage/SDCardManager.hpp"
+#include "Storage/EventLog.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/Retention.hpp"
+#include "Config/Config.hpp"
+#include "Camera/JpegHistory.hpp"
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+StorageStats storageStats;
+
+static StorageQueue storageQueue;
+static bool storageStarted = false;
+
+/**
+ * @brief Копия JPEG для очереди записи, в PSRAM при её наличии
+ * @return Данные с одной ссылкой или nullptr при нехватке памяти
+ */
+StorageBlob *storageBlobCreate(const uint8_t *data, size_t len)
+{
+    uint8_t *copy = (uint8_t *)(psramFound() ? ps_malloc(len) : malloc(len));
+    if (!copy)
+        return nullptr;
+
+    memcpy(copy, data, len);
+    StorageBlob *blob = new StorageBlob;
+    blob->data = copy;
+    blob->len = len;
+    blob->refs = 1;
+    return blob;
+}
+
+/**
+ * @brief Освобождение ссылки на данные JPEG
+ */
+void storageBlobRelease(StorageBlob *blob)
+{
+    if (blob && --blob->refs == 0)
+    {
+        free(blob->data);
+        delete blob;
+    }
+}
+
+/**
+ * @brief Удаление события вместе с его ссылками на данные
+ */
+void storageEventFree(StorageEvent *event)
+{
+    if (!event)
+        return;
+    for (StorageFrame &frame : event->frames)
+        storageBlobRelease(frame.blob);
+    storageBlobRelease(event->photo);
+    delete event;
+}
+
+/**
+ * @brief Сохранение файла JPEG с учётом в счётчиках
+ */
+static bool storageWriteFile(const String &path, const StorageBlob *blob)
+{
+    if (blob && photoArchiveEnsureDir(path) && saveJpegToSD(path, blob->data, blob->len))
+    {
+        storageStats.written++;
+        Serial.println("Saved: " + path);
+        return true;
+    }
+
+    storageStats.failed++;
+    Serial.println("Failed to save: " + path);
+    return false;
+}
+
+/**
+ * @brief Метаданные фотографии со списком записанных кадров истории
+ *
+ * Запись журнала фиксированного размера: длинный список кадров
+ * заменяется их числом.
+ */
+static String storageEventMetadata(const String &metadata, JsonArray pre)
+{
+    if (pre.size() == 0 || metadata.length() == 0)
+        return metadata;
+
+    DynamicJsonDocument doc(1024 + JPEG_HISTORY_MAX_FRAMES * 96);
+    if (deserializeJson(doc, metadata))
+        return metadata;
+
+    doc["pre"] = pre;
+    if (measureJson(doc) > EVENT_PAYLOAD_MAX)
+    {
+        doc.remove("pre");
+        doc["pre_count"] = pre.size();
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
+
+/**
+ * @brief Сохранение события: кадры истории, затем фотография каждой зоны
+ * с записью журнала и индекса
+ *
+ * В метаданные попадают только кадры истории, записанные на карту.
+ */
+static void storageEventWrite(StorageEvent *event)
+{
+    DynamicJsonDocument preDoc(JPEG_HISTORY_MAX_FRAMES * 96);
+    JsonArray pre = preDoc.to<JsonArray>();
+    for (const StorageFrame &frame : event->frames)
+    {
+        if (!storageWriteFile(frame.path, frame.blob))
+            continue;
+        JsonObject item = pre.createNestedObject();
+        item["image"] = frame.path;
+        item["offset_ms"] = frame.offset;
+    }
+
+    for (StoragePhoto &photo : event->photos)
+    {
+        if (!storageWriteFile(photo.path, event->photo))
+            continue;
+
+        // Фотография уже на карте: без записи журнала она остаётся в галерее
+        String metadata = storageEventMetadata(photo.metadata, pre);
+        if (metadata.length() && !eventLogAppend(photo.entry.id, metadata))
+            Serial.println("Event not logged: " + photo.path);
+
+        photo.entry.size = event->photo->len;
+        if (!photoIndexAppend(photo.entry))
+            Serial.println("Not indexed: " + photo.path);
+    }
+}
+
+/**
+ * @brief Цикл задачи записи
+ *
+ * Ожидание очереди ограничено, чтобы журнал событий сбрасывался на карту
+ * и в отсутствие новых записей. Старые фотографии удаляются здесь же,
+ * между записями.
+ */
+static void storageTask(void *parameter)
+{
+    for (;;)
+    {
+        void *item = nullptr;
+        bool received = storageQueuePop(storageQueue, item, EVENT_LOG_SYNC_MS);
+        eventLogSync(false);
+        if (received && item)
+        {
+            uint32_t start = millis();
+            StorageEvent *event = (StorageEvent *)item;
+            storageEventWrite(event);
+            storageStats.lastMs = millis() - start;
+            storageEventFree(event);
+        }
+        retentionEnforce();
+    }
+}
+
+/**
+ * @brief Запуск задачи записи
+ */
+bool startStorageTask()
+{
+    if (storageStarted)
+        return true;
+
+    storageQueueInit(storageQueue, STORAGE_QUEUE_LENGTH);
+    BaseType_t created = xTaskCreatePinnedToCore(storageTask, "storage", STORAGE_TASK_STACK, nullptr,
+                                                 STORAGE_TASK_PRIORITY, nullptr, STORAGE_TASK_CORE);
+    storageStarted = created == pdPASS;
+    return storageStarted;
+}
+
+/**
+ * @brief Постановка события в очередь
+ *
+ * Очередь забирает событие; при отказе оно освобождается здесь же.
+ * При заполненной очереди действует settings.storage_policy: отбрасывается
+ * самое старое событие целиком или новое ждёт места.
+ * @return true - событие принято
+ */
+bool storageEnqueue(StorageEvent *event)
+{
+    if (!storageStarted || !event)
+    {
+        storageEventFree(event);
+        storageStats.dropped++;
+        return false;
+    }
+
+    void *dropped = nullptr;
+    StoragePolicy policy = settings.storage_policy == STORAGE_BLOCK ? STORAGE_BLOCK : STORAGE_DROP_OLDEST;
+    bool sent = storageQueuePush(storageQueue, event, policy, STORAGE_BLOCK_TIMEOUT, dropped);
+    if (dropped)
+    {
+        StorageEvent *oldest = (StorageEvent *)dropped;
+        Serial.println("Storage queue full, dropped event: " +
+                       (oldest->photos.empty() ? String("-") : oldest->photos[0].path));
+        storageEventFree(oldest);
+        storageStats.dropped++;
+    }
+
+    if (!sent)
+    {
+        Serial.println("Storage queue full, dropped event: " +
+                       (event->photos.empty() ? String("-") : event->photos[0].path));
+        storageEventFree(event);
+        storageStats.dropped++;
+        return false;
+    }
+
+    storageStats.queued++;
+    storageStats.depthMax = storageQueue.depthMax;
+    return true;
+}
+
+/**
+ * @brief Число событий в очереди
+ */
+int storageQueueDepth()
+{
+    return storageStarted ? storageQueueCount(storageQueue) : 0;
+}
\ No newline at end of file
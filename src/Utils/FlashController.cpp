@@ -5,6 +5,9 @@
 
 #include "Utils/FlashController.hpp"
 
+// Время последнего выключения вспышки, мс
+static uint32_t flashOffAt = 0;
+
 /**
  * @brief Инициализация пина вспышки
  */
@@ -27,6 +30,8 @@ void onFlash()
  */
 void offFlash()
 {
+    if (digitalRead(FLASH_GPIO_NUM))
+        flashOffAt = millis();
     digitalWrite(FLASH_GPIO_NUM, LOW);
 }
 
@@ -35,5 +40,17 @@ void offFlash()
  */
 void reverseFlash()
 {
-    digitalWrite(FLASH_GPIO_NUM, !digitalRead(FLASH_GPIO_NUM));
+    if (digitalRead(FLASH_GPIO_NUM))
+        offFlash();
+    else
+        onFlash();
+}
+
+/**
+ * @brief Время, после которого кадры сняты без вспышки
+ * @return Время последнего выключения, мс; пока вспышка горит - текущее
+ */
+uint32_t flashOffTime()
+{
+    return digitalRead(FLASH_GPIO_NUM) ? millis() : flashOffAt;
 }
\ No newline at end of file
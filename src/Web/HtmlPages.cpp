@@ -5,6 +5,13 @@
 
 #include "Web/HtmlPages.hpp"
 #include "Config/Config.hpp"
+#include "Detection/CarDetector.hpp"
+#include "Camera/CameraController.hpp"
+#include "Storage/StorageWriter.hpp"
+#include "Storage/EventLog.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/Retention.hpp"
+#include "Storage/PhotoIndex.hpp"
 #include <WiFi.h>
 
 // Внешние объявления
@@ -544,7 +551,8 @@ String getMainPage()
                 <div>
                     <h4>Max Files</h4>
                     <p>)rawliteral";
-    content += String(settings.max_files);
+    content += String(settings.max_files) + " (" + String(retentionStats.evicted) + " evicted, oldest #" +
+               String(retentionStats.oldestId) + ")";
     content += R"rawliteral(</p>
                 </div>
                 <div>
@@ -553,6 +561,54 @@ String getMainPage()
     content += String(settings.roi_width);
     content += R"rawliteral( x )rawliteral";
     content += String(settings.roi_height);
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Frames Analyzed</h4>
+                    <p>)rawliteral";
+    content += String(motionGate.framesAnalyzed);
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Frames Gated</h4>
+                    <p>)rawliteral";
+    content += String(motionGate.framesGated);
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Detection Frame Age</h4>
+                    <p>)rawliteral";
+    content += String(frameAgeMean(detectionFrameAge), 0) + " ms avg, " + String(detectionFrameAge.maxAge) + " ms max";
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Pre-trigger History</h4>
+                    <p>)rawliteral";
+    content += String(jpegHistory.count) + " frames, " + String(jpegHistoryUsed(jpegHistory) / 1024) + " / " +
+               String(jpegHistory.capacity / 1024) + " KB";
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Camera Profile</h4>
+                    <p>)rawliteral";
+    content += String(cameraProfileName(sensorCache.profile)) + ", " + String(sensorCache.switches) + " switches, " +
+               String(sensorCache.skipped) + " skipped";
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Photo Writes</h4>
+                    <p>)rawliteral";
+    content += String(storageStats.written) + " saved, " + String(storageStats.failed) + " failed, " +
+               String(storageStats.dropped) + " dropped, queue " + String(storageQueueDepth()) + " / " +
+               String(STORAGE_QUEUE_LENGTH);
+    content += R"rawliteral(</p>
+                </div>
+                <div>
+                    <h4>Event Log</h4>
+                    <p>)rawliteral";
+    content += String(eventLogStats.records) + " events";
+    if (eventLogStats.records)
+        content += ", ids " + String(eventLogStats.firstId) + " - " + String(eventLogStats.lastId);
     content += R"rawliteral(</p>
                 </div>
             </div>
@@ -594,7 +650,7 @@ String getDetectionSettingsPage()
                 
                 <div class="slider-container">
                     <div class="slider-value">
-                        <label class="form-label">Pixel Threshold</label>
+                        <label class="form-label">Pixel Threshold (0 = auto, Otsu)</label>
                         <span class="value-display" id="thresholdValue">)rawliteral";
     content += String(settings.threshold);
     content += R"rawliteral(</span>
@@ -612,6 +668,18 @@ String getDetectionSettingsPage()
     content += R"rawliteral(" min="1" max="10000">
                 </div>
                 
+                <div class="form-group">
+                    <label class="form-label">Area Applies To</label>
+                    <select class="form-control" id="blob">
+                        <option value="0")rawliteral";
+    content += (!settings.blob ? " selected" : "");
+    content += R"rawliteral(>All dark pixels</option>
+                        <option value="1")rawliteral";
+    content += (settings.blob ? " selected" : "");
+    content += R"rawliteral(>Largest connected blob</option>
+                    </select>
+                </div>
+                
                 <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 15px;">
                     <div class="form-group">
                         <label class="form-label">Dark Pixel Min</label>
@@ -630,7 +698,7 @@ String getDetectionSettingsPage()
                 </div>
                 
                 <div class="form-group">
-                    <label class="form-label">Texture Sensitivity</label>
+                    <label class="form-label">Minimum Texture (gradient energy, 0 = off)</label>
                     <input type="number" class="form-control" id="texture" 
                            value=")rawliteral";
     content += String(settings.texture);
@@ -638,11 +706,210 @@ String getDetectionSettingsPage()
                 </div>
                 
                 <div class="form-group">
-                    <label class="form-label">Maximum Files</label>
-                    <input type="number" class="form-control" id="max_files" 
+                    <label class="form-label">Integral Image</label>
+                    <select class="form-control" id="integral_mode">
+                        <option value="0")rawliteral";
+    content += (settings.integral_mode == 0 ? " selected" : "");
+    content += R"rawliteral(>Off</option>
+                        <option value="1")rawliteral";
+    content += (settings.integral_mode == 1 ? " selected" : "");
+    content += R"rawliteral(>Dark mask</option>
+                        <option value="2")rawliteral";
+    content += (settings.integral_mode == 2 ? " selected" : "");
+    content += R"rawliteral(>Dark mask + luminance</option>
+                    </select>
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Detection Method</label>
+                    <select class="form-control" id="background">
+                        <option value="0")rawliteral";
+    content += (!settings.background ? " selected" : "");
+    content += R"rawliteral(>Dark pixels (fixed threshold)</option>
+                        <option value="1")rawliteral";
+    content += (settings.background ? " selected" : "");
+    content += R"rawliteral(>Background difference</option>
+                    </select>
+                </div>
+                
+                <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 15px;">
+                    <div class="form-group">
+                        <label class="form-label">Background Adaptation (1-8)</label>
+                        <input type="number" class="form-control" id="bg_shift" min="1" max="8"
+                               value=")rawliteral";
+    content += String(settings.bg_shift);
+    content += R"rawliteral(">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">Foreground Threshold</label>
+                        <input type="number" class="form-control" id="fg_threshold" min="1" max="255"
+                               value=")rawliteral";
+    content += String(settings.fg_threshold);
+    content += R"rawliteral(">
+                    </div>
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Sampling Stride</label>
+                    <select class="form-control" id="stride">
+                        <option value="1")rawliteral";
+    content += (settings.stride != 2 && settings.stride != 4 ? " selected" : "");
+    content += R"rawliteral(>Every pixel</option>
+                        <option value="2")rawliteral";
+    content += (settings.stride == 2 ? " selected" : "");
+    content += R"rawliteral(>Every 2nd pixel and row</option>
+                        <option value="4")rawliteral";
+    content += (settings.stride == 4 ? " selected" : "");
+    content += R"rawliteral(>Every 4th pixel and row</option>
+                    </select>
+                </div>
+                
+                <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 15px;">
+                    <div class="form-group">
+                        <label class="form-label">Confirm Frames (N)</label>
+                        <input type="number" class="form-control" id="confirm_n" min="1" max="16"
+                               value=")rawliteral";
+    content += String(settings.confirm_n);
+    content += R"rawliteral(">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">Of Last Frames (M)</label>
+                        <input type="number" class="form-control" id="confirm_m" min="1" max="16"
+                               value=")rawliteral";
+    content += String(settings.confirm_m);
+    content += R"rawliteral(">
+                    </div>
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Capture Pipeline</label>
+                    <select class="form-control" id="single_mode">
+                        <option value="0")rawliteral";
+    content += (!settings.single_mode ? " selected" : "");
+    content += R"rawliteral(>Switch modes (QQVGA grayscale / SVGA photo)</option>
+                        <option value="1")rawliteral";
+    content += (settings.single_mode ? " selected" : "");
+    content += R"rawliteral(>Single mode (SVGA JPEG, decoded for detection)</option>
+                    </select>
+                </div>
+                
+                <div style="display: grid; grid-template-columns: 1fr 1fr 1fr; gap: 15px;">
+                    <div class="form-group">
+                        <label class="form-label">Pre-trigger Frames (0 = off)</label>
+                        <input type="number" class="form-control" id="history_frames" min="0" max="32"
+                               value=")rawliteral";
+    content += String(settings.history_frames);
+    content += R"rawliteral(">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">History Budget (KB, PSRAM)</label>
+                        <input type="number" class="form-control" id="history_kb" min="0" max="2048"
+                               value=")rawliteral";
+    content += String(settings.history_kb);
+    content += R"rawliteral(">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">History Interval (ms)</label>
+                        <input type="number" class="form-control" id="history_interval" min="0"
+                               value=")rawliteral";
+    content += String(settings.history_interval);
+    content += R"rawliteral(">
+                    </div>
+                </div>
+                
+                <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 15px;">
+                    <div class="form-group">
+                        <label class="form-label">Photo Burst (frames, 1 = off)</label>
+                        <input type="number" class="form-control" id="burst_frames" min="1" max="8"
+                               value=")rawliteral";
+    content += String(settings.burst_frames);
+    content += R"rawliteral(">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">Sharpness Scoring</label>
+                        <select class="form-control" id="burst_fine">
+                            <option value="0")rawliteral";
+    content += (!settings.burst_fine ? " selected" : "");
+    content += R"rawliteral(>Fast (1/8 scale)</option>
+                            <option value="1")rawliteral";
+    content += (settings.burst_fine ? " selected" : "");
+    content += R"rawliteral(>Fine (1/4 scale)</option>
+                        </select>
+                    </div>
+                </div>
+                
+                <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 15px;">
+                    <div class="form-group">
+                        <label class="form-label">Exposure Settle Limit (ms)</label>
+                        <input type="number" class="form-control" id="settle_max" min="0" max="5000"
+                               value=")rawliteral";
+    content += String(settings.settle_max);
+    content += R"rawliteral(">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">Settled Brightness Change</label>
+                        <input type="number" class="form-control" id="settle_tolerance" min="0" max="255"
+                               value=")rawliteral";
+    content += String(settings.settle_tolerance);
+    content += R"rawliteral(">
+                    </div>
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Sensor Profile</label>
+                    <select class="form-control" id="night_mode">
+                        <option value="0")rawliteral";
+    content += (!settings.night_mode ? " selected" : "");
+    content += R"rawliteral(>Day</option>
+                        <option value="1")rawliteral";
+    content += (settings.night_mode ? " selected" : "");
+    content += R"rawliteral(>Night (higher gain ceiling, DSP exposure)</option>
+                    </select>
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Full Save Queue</label>
+                    <select class="form-control" id="storage_policy">
+                        <option value="0")rawliteral";
+    content += (settings.storage_policy == 0 ? " selected" : "");
+    content += R"rawliteral(>Drop oldest pending photo</option>
+                        <option value="1")rawliteral";
+    content += (settings.storage_policy == 1 ? " selected" : "");
+    content += R"rawliteral(>Wait for space (up to 2 s)</option>
+                    </select>
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Maximum Frame Age (ms, 0 = any)</label>
+                    <input type="number" class="form-control" id="max_frame_age" min="0"
+                           value=")rawliteral";
+    content += String(settings.max_frame_age);
+    content += R"rawliteral(">
+                </div>
+                
+                <div class="form-group">
+                    <label class="form-label">Motion Gate (0 = analyze every frame)</label>
+                    <input type="number" class="form-control" id="motion_gate" min="0" max="255"
                            value=")rawliteral";
+    content += String(settings.motion_gate);
+    content += R"rawliteral(">
+                </div>
+                
+                <div style="display: grid; grid-template-columns: 1fr 1fr; gap: 15px;">
+                    <div class="form-group">
+                        <label class="form-label">Maximum Files (0 = no limit)</label>
+                        <input type="number" class="form-control" id="max_files" 
+                               value=")rawliteral";
     content += String(settings.max_files);
-    content += R"rawliteral(" min="1" max="1000">
+    content += R"rawliteral(" min="0" max="100000">
+                    </div>
+                    <div class="form-group">
+                        <label class="form-label">Minimum Free Space (%, 0 = off)</label>
+                        <input type="number" class="form-control" id="min_free_percent" min="0" max="90"
+                               value=")rawliteral";
+    content += String(settings.min_free_percent);
+    content += R"rawliteral(">
+                    </div>
                 </div>
                 
                 <button type="button" class="btn btn-block" onclick="saveDetectionSettings()">
@@ -651,7 +918,45 @@ String getDetectionSettingsPage()
             </form>
         </div>
         
+        <div class="card">
+            <h2 class="card-title">Live ROI Histogram</h2>
+            <canvas id="histogram" width="512" height="160" style="width: 100%; background: #f8f9fa; border-radius: 6px;"></canvas>
+            <p id="histogramStats" style="color: #7f8c8d; font-size: 14px; margin-top: 10px;">Loading...</p>
+        </div>
+        
         <script>
+            async function refreshHistogram() {
+                try {
+                    const response = await fetch('/histogram');
+                    if (!response.ok) {
+                        document.getElementById('histogramStats').textContent = 'Histogram not available';
+                        return;
+                    }
+                    const data = await response.json();
+                    const canvas = document.getElementById('histogram');
+                    const ctx = canvas.getContext('2d');
+                    const peak = Math.max(1, ...data.bins);
+                    ctx.clearRect(0, 0, canvas.width, canvas.height);
+                    ctx.fillStyle = '#3498db';
+                    data.bins.forEach((v, i) => {
+                        const h = v / peak * canvas.height;
+                        ctx.fillRect(i * 2, canvas.height - h, 2, h);
+                    });
+                    ctx.fillStyle = '#e74c3c';
+                    ctx.fillRect(data.threshold * 2, 0, 2, canvas.height);
+                    document.getElementById('histogramStats').textContent =
+                        'Threshold: ' + data.threshold + ' (Otsu ' + data.otsu +
+                        (data.otsu_reliable ? '' : ', not separated') + '), mean: ' + data.mean.toFixed(1) +
+                        ', variance: ' + data.variance.toFixed(1) + ', p10/p50/p90: ' +
+                        data.p10 + '/' + data.p50 + '/' + data.p90;
+                } catch (error) {
+                    document.getElementById('histogramStats').textContent = 'Error: ' + error;
+                }
+            }
+            refreshHistogram();
+            setInterval(refreshHistogram, 2000);
+            
+
             async function saveDetectionSettings() {
                 const formData = new FormData();
                 formData.append('distance', document.getElementById('distance').value);
@@ -661,7 +966,28 @@ String getDetectionSettingsPage()
                 formData.append('dark_min', document.getElementById('dark_min').value);
                 formData.append('dark_max', document.getElementById('dark_max').value);
                 formData.append('texture', document.getElementById('texture').value);
+                formData.append('integral_mode', document.getElementById('integral_mode').value);
+                formData.append('background', document.getElementById('background').value);
+                formData.append('bg_shift', document.getElementById('bg_shift').value);
+                formData.append('fg_threshold', document.getElementById('fg_threshold').value);
+                formData.append('motion_gate', document.getElementById('motion_gate').value);
+                formData.append('blob', document.getElementById('blob').value);
+                formData.append('stride', document.getElementById('stride').value);
+                formData.append('confirm_n', document.getElementById('confirm_n').value);
+                formData.append('confirm_m', document.getElementById('confirm_m').value);
+                formData.append('single_mode', document.getElementById('single_mode').value);
+                formData.append('history_frames', document.getElementById('history_frames').value);
+                formData.append('history_kb', document.getElementById('history_kb').value);
+                formData.append('history_interval', document.getElementById('history_interval').value);
+                formData.append('burst_frames', document.getElementById('burst_frames').value);
+                formData.append('burst_fine', document.getElementById('burst_fine').value);
+                formData.append('max_frame_age', document.getElementById('max_frame_age').value);
+                formData.append('settle_max', document.getElementById('settle_max').value);
+                formData.append('settle_tolerance', document.getElementById('settle_tolerance').value);
+                formData.append('night_mode', document.getElementById('night_mode').value);
+                formData.append('storage_policy', document.getElementById('storage_policy').value);
                 formData.append('max_files', document.getElementById('max_files').value);
+                formData.append('min_free_percent', document.getElementById('min_free_percent').value);
                 
                 try {
                     const response = await fetch('/save_detection', { method: 'POST', body: formData });
@@ -940,6 +1266,20 @@ String getROISettingsPage()
     content += "border: 2px solid #f39c12; background: rgba(243, 156, 18, 0.2); box-sizing: border-box; pointer-events: none;\">";
     content += "<div style=\"position: absolute; top: -25px; left: 0; background: #f39c12; color: white; padding: 2px 8px; border-radius: 3px; font-size: 12px; font-weight: 600;\">ROI</div>";
     content += "</div>";
+
+    // Overlays of additional zones
+    for (int i = 1; i < settings.zone_count; i++)
+    {
+        const DetectionZone &zone = settings.zones[i];
+        content += "<div style=\"position: absolute; ";
+        content += "top: " + String(zone.y * 2) + "px; ";
+        content += "left: " + String(zone.x * 2) + "px; ";
+        content += "width: " + String(zone.width * 2) + "px; ";
+        content += "height: " + String(zone.height * 2) + "px; ";
+        content += "border: 2px dashed #1abc9c; background: rgba(26, 188, 156, 0.15); box-sizing: border-box; pointer-events: none;\">";
+        content += "<div style=\"position: absolute; top: 2px; left: 2px; background: #1abc9c; color: white; padding: 1px 6px; border-radius: 3px; font-size: 11px;\">Zone " + String(i) + "</div>";
+        content += "</div>";
+    }
     content += "</div>";
     
     // Camera status
@@ -1021,6 +1361,31 @@ String getROISettingsPage()
     content += "</form>";
     content += "</div>";
     
+    // Additional zones
+    content += "<div style=\"background: #f8f9fa; padding: 20px; border-radius: 8px; margin-bottom: 25px;\">";
+    content += "<h3 style=\"color: #2c3e50; margin-bottom: 15px;\"><i class=\"fas fa-th-large\"></i> Additional Zones</h3>";
+    content += "<p style=\"color: #7f8c8d; font-size: 14px; margin-bottom: 15px;\">Zone 0 is the ROI above. Up to " + String(MAX_DETECTION_ZONES - 1) + " extra parking bays can be evaluated in the same frame.</p>";
+    content += "<table style=\"width: 100%; border-collapse: collapse; margin-bottom: 15px;\" id=\"zonesTable\">";
+    content += "<tr><th>Zone</th><th>X</th><th>Y</th><th>Width</th><th>Height</th><th>Threshold</th><th>Area</th><th></th></tr>";
+    for (int i = 1; i < settings.zone_count; i++)
+    {
+        const DetectionZone &zone = settings.zones[i];
+        content += "<tr><td>" + String(i) + "</td>";
+        content += "<td><input type=\"number\" class=\"form-control\" value=\"" + String(zone.x) + "\" min=\"0\" max=\"160\"></td>";
+        content += "<td><input type=\"number\" class=\"form-control\" value=\"" + String(zone.y) + "\" min=\"0\" max=\"120\"></td>";
+        content += "<td><input type=\"number\" class=\"form-control\" value=\"" + String(zone.width) + "\" min=\"1\" max=\"160\"></td>";
+        content += "<td><input type=\"number\" class=\"form-control\" value=\"" + String(zone.height) + "\" min=\"1\" max=\"120\"></td>";
+        content += "<td><input type=\"number\" class=\"form-control\" value=\"" + String(zone.threshold) + "\" min=\"0\" max=\"255\"></td>";
+        content += "<td><input type=\"number\" class=\"form-control\" value=\"" + String(zone.area) + "\" min=\"1\" max=\"19200\"></td>";
+        content += "<td><button type=\"button\" class=\"btn\" onclick=\"this.closest('tr').remove()\">&times;</button></td></tr>";
+    }
+    content += "</table>";
+    content += "<div style=\"display: flex; gap: 10px;\">";
+    content += "<button type=\"button\" class=\"btn\" onclick=\"addZone()\">Add Zone</button>";
+    content += "<button type=\"button\" class=\"btn\" onclick=\"saveZones()\">Save Zones</button>";
+    content += "</div>";
+    content += "</div>";
+    
     // Best practices
     content += "<div style=\"background: #e8f4fc; padding: 20px; border-radius: 8px;\">";
     content += "<h3 style=\"color: #3498db; margin-bottom: 15px;\"><i class=\"fas fa-lightbulb\"></i> Best Practices</h3>";
@@ -1071,6 +1436,34 @@ String getROISettingsPage()
     content += "}";
     content += "}";
     
+    // Additional zones
+    content += "function addZone() {";
+    content += "const table = document.getElementById('zonesTable');";
+    content += "if (table.rows.length >= " + String(MAX_DETECTION_ZONES) + ") { alert('Zone limit reached'); return; }";
+    content += "const row = table.insertRow();";
+    content += "row.insertCell().textContent = table.rows.length - 1;";
+    content += "[0, 0, 40, 30, " + String(settings.threshold) + ", " + String(settings.area) + "].forEach(v => {";
+    content += "row.insertCell().innerHTML = '<input type=\"number\" class=\"form-control\" value=\"' + v + '\">';";
+    content += "});";
+    content += "row.insertCell().innerHTML = '<button type=\"button\" class=\"btn\" onclick=\"this.closest(\\'tr\\').remove()\">&times;</button>';";
+    content += "}";
+
+    content += "async function saveZones() {";
+    content += "const rows = Array.from(document.getElementById('zonesTable').rows).slice(1);";
+    content += "const zones = rows.map(r => {";
+    content += "const v = Array.from(r.querySelectorAll('input')).map(i => parseInt(i.value) || 0);";
+    content += "return { x: v[0], y: v[1], width: v[2], height: v[3], threshold: v[4], area: v[5] };";
+    content += "});";
+    content += "const formData = new FormData();";
+    content += "formData.append('zones', JSON.stringify(zones));";
+    content += "try {";
+    content += "const response = await fetch('/save_zones', { method: 'POST', body: formData });";
+    content += "if (response.ok) { alert('Zones saved!'); location.reload(); } else { alert('Error saving zones!'); }";
+    content += "} catch (error) {";
+    content += "alert('Error: ' + error);";
+    content += "}";
+    content += "}";
+    
     // Video stream controls
     content += "let streamActive = true;";
     content += "function toggleStream() {";
@@ -1216,32 +1609,11 @@ String getPhotosListPage()
                 </div>
                 )rawliteral";
     } else {
-        File root = SD_MMC.open("/");
-        if (!root) {
-            content += R"rawliteral(
-                <div style="text-align: center; padding: 40px; color: #e74c3c;">
-                    <h3>SD Card Error</h3>
-                    <p>Failed to open SD card root directory.</p>
-                </div>
-                )rawliteral";
-        } else {
-            // Счетчик файлов
-            int fileCount = 0;
-            std::vector<String> jpgFiles;
-            
-            // Сначала собираем все JPG файлы
-            File file = root.openNextFile();
-            while (file) {
-                String fileName = file.name();
-                if (!file.isDirectory() && 
-                    (fileName.endsWith(".jpg") || fileName.endsWith(".JPG"))) {
-                    jpgFiles.push_back(fileName);
-                    fileCount++;
-                }
-                file.close();
-                file = root.openNextFile();
-            }
-            root.close();
+        {
+            // Не более 30 фотографий для скорости загрузки; индекс читается
+            // с конца (новые сначала), размер хранится в нём же
+            PhotoIndexEntry photos[30];
+            int fileCount = photoIndexNewest(photos, 30);
             
             if (fileCount == 0) {
                 content += R"rawliteral(
@@ -1251,28 +1623,12 @@ String getPhotosListPage()
                     </div>
                     )rawliteral";
             } else {
-                // Сортируем файлы по имени (новые сначала)
-                std::sort(jpgFiles.begin(), jpgFiles.end(), [](const String& a, const String& b) {
-                    return a > b;
-                });
-                
-                // Ограничиваем количество отображаемых файлов
-                int maxFiles = 30; // Не более 30 фотографий для скорости загрузки
-                if (jpgFiles.size() > maxFiles) {
-                    jpgFiles.resize(maxFiles);
-                }
-                
                 // Создаем сетку карточек
                 content += "<div style=\"display: grid; grid-template-columns: repeat(auto-fill, minmax(250px, 1fr)); gap: 20px;\">";
                 
-                for (const String& fileName : jpgFiles) {
-                    // Получаем размер файла для отображения
-                    File imgFile = SD_MMC.open(("/" + fileName).c_str(), FILE_READ);
-                    size_t fileSize = 0;
-                    if (imgFile) {
-                        fileSize = imgFile.size();
-                        imgFile.close();
-                    }
+                for (int i = 0; i < fileCount; i++) {
+                    String fileName = photoName(photos[i].id);
+                    size_t fileSize = photos[i].size;
                     
                     // Форматируем размер
                     String sizeStr;
@@ -1306,7 +1662,8 @@ String getPhotosListPage()
                     
                     // Размер файла
                     content += "<div style=\"font-size: 12px; color: #7f8c8d; display: flex; justify-content: space-between;\">";
-                    content += "<span>Size: " + sizeStr + "</span>";
+                    content += "<span>Size: " + sizeStr + ", zone " + String(photos[i].zone) + ", " +
+                               "distance " + String(photos[i].distance) + "</span>";
                     
                     // Кнопка удаления
                     content += "<button onclick=\"deletePhoto('" + fileName + "')\" ";
@@ -1323,7 +1680,7 @@ String getPhotosListPage()
                 
                 // Показываем количество файлов
                 content += "<div style=\"margin-top: 20px; padding: 10px; background: #f8f9fa; border-radius: 6px; text-align: center;\">";
-                content += "<span style=\"color: #7f8c8d; font-size: 14px;\">Showing " + String(fileCount) + " photos</span>";
+                content += "<span style=\"color: #7f8c8d; font-size: 14px;\">Showing " + String(fileCount) + " of " + String(photoIndexStats.live) + " photos</span>";
                 content += "</div>";
             }
         }
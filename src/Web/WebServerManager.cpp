@@ -9,6 +9,13 @@
 #include "Web/HtmlPages.hpp"
 #include "Config/Config.hpp"
 #include "Storage/SDCardManager.hpp"
+#include "Storage/EventLog.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include <SD_MMC.h>
+#include "Detection/CarDetector.hpp"
+#include "Detection/Histogram.hpp"
+#include "Detection/BackgroundModel.hpp"
+#include "Camera/CameraController.hpp"
 #include <esp_camera.h>
 
 // Внешние объявления
@@ -35,8 +42,17 @@ void setupWebServer()
     server.on("/save_detection", HTTP_POST, handleSaveDetection);
     server.on("/save_wifi", HTTP_POST, handleSaveWifi);
     server.on("/save_roi", HTTP_POST, handleSaveROI);
+    server.on("/save_zones", HTTP_POST, handleSaveZones);
+    server.on("/roi_stats", HTTP_GET, handleROIStats);
+    server.on("/histogram", HTTP_GET, handleHistogram);
+    server.on("/frame_age", HTTP_GET, handleFrameAge);
+    server.on("/camera_profiles", HTTP_GET, handleCameraProfiles);
+    server.on("/event", HTTP_GET, handleEvent);
+    server.on("/events", HTTP_GET, handleEvents);
     server.on("/list_photos", HTTP_GET, handleListPhotos);
     server.on("/delete_photo", HTTP_POST, handleDeletePhoto);
+    server.on("/download_photo", HTTP_GET, handleDownloadPhoto);
+    server.on("/list_files", HTTP_GET, handleListFiles);
 
     // Новые эндпоинты для видеопотока и файлов
     // server.on("/stream", HTTP_GET, handleStream);
@@ -91,8 +107,38 @@ void handleSaveDetection()
     settings.dark_min = server.arg("dark_min").toFloat();
     settings.dark_max = server.arg("dark_max").toFloat();
     settings.texture = server.arg("texture").toFloat();
-    settings.max_files = server.arg("max_files").toInt();
+    settings.integral_mode = server.arg("integral_mode").toInt();
+    settings.background = server.arg("background") == "1";
+    settings.bg_shift = constrain((int)server.arg("bg_shift").toInt(), BG_SHIFT_MIN, BG_SHIFT_MAX);
+    settings.fg_threshold = server.arg("fg_threshold").toInt();
+    settings.motion_gate = server.arg("motion_gate").toInt();
+    settings.blob = server.arg("blob") == "1";
+    settings.stride = server.arg("stride").toInt();
+    settings.confirm_m = constrain(server.arg("confirm_m").toInt(), 1, OCCUPANCY_MAX_WINDOW);
+    settings.confirm_n = constrain(server.arg("confirm_n").toInt(), 1, settings.confirm_m);
+    settings.single_mode = server.arg("single_mode") == "1";
+
+    int historyFrames = constrain(server.arg("history_frames").toInt(), 0, JPEG_HISTORY_MAX_FRAMES);
+    int historyKb = constrain(server.arg("history_kb").toInt(), 0, 2048);
+    bool historyChanged = historyFrames != settings.history_frames || historyKb != settings.history_kb;
+    settings.history_frames = historyFrames;
+    settings.history_kb = historyKb;
+    settings.history_interval = max(0, (int)server.arg("history_interval").toInt());
+    settings.burst_frames = constrain(server.arg("burst_frames").toInt(), 1, 8);
+    settings.burst_fine = server.arg("burst_fine") == "1";
+    settings.max_frame_age = max(0, (int)server.arg("max_frame_age").toInt());
+    settings.settle_max = constrain(server.arg("settle_max").toInt(), 0, 5000);
+    settings.settle_tolerance = constrain(server.arg("settle_tolerance").toInt(), 0, 255);
+    settings.night_mode = server.arg("night_mode") == "1";
+    settings.storage_policy = constrain(server.arg("storage_policy").toInt(), 0, 1);
+    settings.max_files = max(0, (int)server.arg("max_files").toInt());
+    settings.min_free_percent = constrain(server.arg("min_free_percent").toInt(), 0, 90);
 
+    updateROICoordinates();
+    motionGateReset(motionGate);
+    switchToDetectionMode();
+    if (historyChanged)
+        setupJpegHistory();
     saveSettings();
 
     server.send(200, "text/plain", "OK");
@@ -121,12 +167,266 @@ void handleSaveROI()
     settings.roi_x = server.arg("x").toInt();
     settings.roi_y = server.arg("y").toInt();
 
+    updateROICoordinates();
     saveSettings();
+
+    server.send(200, "text/plain", "OK");
+}
+
+/**
+ * @brief Обработчик сохранения дополнительных зон детекции
+ *
+ * Ожидает аргумент zones - JSON массив зон 1..N-1, зона 0 задаётся ROI.
+ */
+void handleSaveZones()
+{
+    DynamicJsonDocument doc(1024);
+    if (deserializeJson(doc, server.arg("zones")))
+    {
+        server.send(400, "text/plain", "Invalid zones");
+        return;
+    }
+
+    settings.zone_count = 1;
+    for (JsonObject zone : doc.as<JsonArray>())
+    {
+        if (settings.zone_count >= MAX_DETECTION_ZONES)
+            break;
+
+        DetectionZone &z = settings.zones[settings.zone_count++];
+        z.x = zone["x"] | 0;
+        z.y = zone["y"] | 0;
+        z.width = zone["width"] | 80;
+        z.height = zone["height"] | 60;
+        z.threshold = zone["threshold"] | settings.threshold;
+        z.area = zone["area"] | settings.area;
+    }
+
+    resetZones();
     updateROICoordinates();
+    saveSettings();
 
     server.send(200, "text/plain", "OK");
 }
 
+/**
+ * @brief Обработчик статистики произвольной области последнего кадра
+ */
+void handleROIStats()
+{
+    int x = server.hasArg("x") ? server.arg("x").toInt() : settings.roi_x;
+    int y = server.hasArg("y") ? server.arg("y").toInt() : settings.roi_y;
+    int width = server.hasArg("width") ? server.arg("width").toInt() : settings.roi_width;
+    int height = server.hasArg("height") ? server.arg("height").toInt() : settings.roi_height;
+
+    RegionStats stats;
+    if (!getRegionStats(x, y, width, height, stats))
+    {
+        server.send(404, "text/plain", "No integral image available");
+        return;
+    }
+
+    DynamicJsonDocument doc(256);
+    doc["totalPixels"] = stats.totalPixels;
+    doc["darkPixels"] = stats.darkPixels;
+    doc["darkRatio"] = stats.darkRatio;
+    doc["meanLuma"] = stats.meanLuma;
+
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+/**
+ * @brief Обработчик гистограммы яркости зоны на свежем кадре
+ */
+void handleHistogram()
+{
+    int zoneIndex = server.hasArg("zone") ? server.arg("zone").toInt() : 0;
+    if (zoneIndex < 0 || zoneIndex >= settings.zone_count)
+    {
+        server.send(400, "text/plain", "Invalid zone");
+        return;
+    }
+
+    const FrameSlot *frame = acquireLatestFrame(0);
+    if (!frame)
+    {
+        server.send(503, "text/plain", "Grayscale frame not available");
+        return;
+    }
+
+    const DetectionZone &zone = settings.zones[zoneIndex];
+    PixelRect region;
+    region.x = max(0, zone.x);
+    region.y = max(0, zone.y);
+    region.width = max(0, min(zone.x + zone.width, frame->width) - region.x);
+    region.height = max(0, min(zone.y + zone.height, frame->height) - region.y);
+    region.threshold = zone.threshold;
+
+    uint32_t bins[HISTOGRAM_BINS];
+    buildHistogram(frame->buf, frame->width, region, bins);
+    uint32_t timestamp = frame->timestamp;
+    releaseLatestFrame(frame);
+
+    uint32_t age = millis() - timestamp;
+    frameAgeRecord(webFrameAge, age, settings.max_frame_age);
+
+    HistogramStats stats;
+    histogramStats(bins, stats);
+
+    DynamicJsonDocument doc(6144);
+    doc["zone"] = zoneIndex;
+    doc["timestamp"] = timestamp;
+    doc["age"] = age;
+    if (zone.threshold > 0)
+        doc["threshold"] = zone.threshold;
+    else
+        doc["threshold"] = stats.otsuReliable ? stats.otsuThreshold : zoneStates[zoneIndex].autoThreshold;
+    doc["otsu"] = stats.otsuThreshold;
+    doc["otsu_reliable"] = stats.otsuReliable;
+    doc["mean"] = stats.mean;
+    doc["variance"] = stats.variance;
+    doc["p10"] = stats.p10;
+    doc["p50"] = stats.p50;
+    doc["p90"] = stats.p90;
+    JsonArray array = doc.createNestedArray("bins");
+    for (int i = 0; i < HISTOGRAM_BINS; i++)
+    {
+        array.add(bins[i]);
+    }
+
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+/**
+ * @brief Гистограмма возраста кадров в объекте JSON
+ */
+static void frameAgeToJson(const FrameAgeStats &stats, JsonObject object)
+{
+    object["count"] = stats.count;
+    object["stale"] = stats.stale;
+    object["mean"] = frameAgeMean(stats);
+    object["max"] = stats.maxAge;
+    JsonArray buckets = object.createNestedArray("buckets");
+    for (int i = 0; i < FRAME_AGE_BUCKETS; i++)
+    {
+        buckets.add(stats.buckets[i]);
+    }
+}
+
+/**
+ * @brief Обработчик статистики возраста кадров (задержка от захвата до решения)
+ *
+ * Параметр reset=1 обнуляет статистику после ответа.
+ */
+void handleFrameAge()
+{
+    DynamicJsonDocument doc(1024);
+    doc["max_frame_age"] = settings.max_frame_age;
+    JsonArray bounds = doc.createNestedArray("bounds");
+    for (int i = 0; i < FRAME_AGE_BUCKETS - 1; i++)
+    {
+        bounds.add(frameAgeBounds[i]);
+    }
+    frameAgeToJson(detectionFrameAge, doc.createNestedObject("detection"));
+    frameAgeToJson(webFrameAge, doc.createNestedObject("web"));
+
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+
+    if (server.arg("reset") == "1")
+    {
+        frameAgeReset(detectionFrameAge);
+        frameAgeReset(webFrameAge);
+    }
+}
+
+/**
+ * @brief Обработчик статистики профилей сенсора и владельцев камеры
+ */
+void handleCameraProfiles()
+{
+    DynamicJsonDocument doc(2048);
+    doc["current"] = cameraProfileName(sensorCache.profile);
+    doc["writes"] = sensorCache.writes;
+    doc["elided"] = sensorCache.elided;
+    doc["skipped"] = sensorCache.skipped;
+    JsonArray profiles = doc.createNestedArray("profiles");
+    for (int i = 0; i < PROFILE_COUNT; i++)
+    {
+        const CameraProfileStats &stats = profileStats[i];
+        JsonObject profile = profiles.createNestedObject();
+        profile["name"] = cameraProfileName(i);
+        profile["switches"] = stats.switches;
+        profile["last_us"] = stats.lastUs;
+        profile["max_us"] = stats.maxUs;
+        profile["mean_us"] = stats.switches ? stats.totalUs / stats.switches : 0;
+    }
+
+    JsonArray owners = doc.createNestedArray("owners");
+    for (int i = 0; i < OWNER_COUNT; i++)
+    {
+        const CameraOwnerStats &stats = cameraArbiter.stats[i];
+        JsonObject owner = owners.createNestedObject();
+        owner["name"] = cameraOwnerName(i);
+        owner["requests"] = stats.requests;
+        owner["switches"] = stats.switches;
+        owner["coalesced"] = stats.coalesced;
+        owner["timeouts"] = stats.timeouts;
+        owner["wait_max_ms"] = stats.waitMax;
+        owner["wait_mean_ms"] = stats.requests ? stats.waitTotal / stats.requests : 0;
+    }
+
+    String json;
+    serializeJson(doc, json);
+    server.send(200, "application/json", json);
+}
+
+/**
+ * @brief Обработчик метаданных события по номеру (параметр id)
+ */
+void handleEvent()
+{
+    String json;
+    if (!eventLogFind(server.arg("id").toInt(), json))
+    {
+        server.send(404, "text/plain", "Event not found");
+        return;
+    }
+    server.send(200, "application/json", json);
+}
+
+/**
+ * @brief Обработчик списка событий журнала
+ *
+ * Параметры: from - наименьший номер события, limit - число событий
+ * (не больше 50). Записи журнала отдаются без разбора.
+ */
+void handleEvents()
+{
+    uint32_t from = server.hasArg("from") ? server.arg("from").toInt() : 0;
+    int limit = server.hasArg("limit") ? constrain(server.arg("limit").toInt(), 1, 50) : 20;
+
+    EventLogCursor cursor;
+    eventLogSeek(cursor, from);
+
+    String response = "[";
+    uint32_t id;
+    String json;
+    for (int i = 0; i < limit && eventLogNext(cursor, id, json); i++)
+    {
+        if (i > 0)
+            response += ",";
+        response += json;
+    }
+    response += "]";
+    server.send(200, "application/json", response);
+}
+
 /**
  * @brief Обработчик списка фотографий
  */
@@ -140,39 +440,54 @@ void handleListPhotos()
 
 /**
  * @brief Обработчик удаления фотографии
+ *
+ * Параметр file - имя фотографии (car_NNNNN.jpg); путь в архиве
+ * вычисляется по номеру, вместе с фото удаляются его кадры истории.
  */
 void handleDeletePhoto() {
-    // // // if (!sd_initialized) {
-    // // //     server.send(500, "text/plain", "SD card not available");
-    // // //     return;
-    // // // }
+    if (!sd_initialized) {
+        server.send(500, "text/plain", "SD card not available");
+        return;
+    }
     
-    // // // if (server.hasArg("file")) {
-    // // //     String filename = server.arg("file");
-        
-    // // //     // Удаляем файл фото
-    // // //     if (SD_MMC.exists(("/" + filename).c_str())) {
-    // // //         SD_MMC.remove(("/" + filename).c_str());
-            
-    // // //         // Пытаемся удалить соответствующий JSON файл
-    // // //         String jsonFilename = filename;
-    // // //         if (jsonFilename.endsWith(".jpg") || jsonFilename.endsWith(".JPG")) {
-    // // //             jsonFilename = jsonFilename.substring(0, jsonFilename.length() - 4) + ".json";
-    // // //         } else if (jsonFilename.endsWith(".jpeg") || jsonFilename.endsWith(".JPEG")) {
-    // // //             jsonFilename = jsonFilename.substring(0, jsonFilename.length() - 5) + ".json";
-    // // //         }
-            
-    // // //         if (SD_MMC.exists(("/" + jsonFilename).c_str())) {
-    // // //             SD_MMC.remove(("/" + jsonFilename).c_str());
-    // // //         }
-            
-    // // //         server.send(200, "text/plain", "File deleted");
-    // // //     } else {
-    // // //         server.send(404, "text/plain", "File not found");
-    // // //     }
-    // // // } else {
-    // // //     server.send(400, "text/plain", "Missing file parameter");
-    // // // }
+    if (!server.hasArg("file")) {
+        server.send(400, "text/plain", "Missing file parameter");
+        return;
+    }
+
+    if (photoArchiveDelete(server.arg("file"))) {
+        server.send(200, "text/plain", "File deleted");
+    } else {
+        server.send(404, "text/plain", "File not found");
+    }
+}
+
+/**
+ * @brief Обработчик загрузки фотографии из архива по имени (параметр file)
+ */
+void handleDownloadPhoto() {
+    if (!sd_initialized) {
+        server.send(500, "text/plain", "SD card not available");
+        return;
+    }
+
+    String path = photoResolve(server.arg("file"));
+    File file = path.length() ? SD_MMC.open(path.c_str(), FILE_READ) : File();
+    if (!file) {
+        server.send(404, "text/plain", "File not found");
+        return;
+    }
+
+    server.sendHeader("Cache-Control", "max-age=86400");
+    server.streamFile(file, "image/jpeg");
+    file.close();
+}
+
+/**
+ * @brief Обработчик текстового списка последних фотографий
+ */
+void handleListFiles() {
+    server.send(200, "text/html", listFiles());
 }
 
 /**
@@ -185,6 +500,13 @@ void handleStream()
         return;
     }
     
+    // Поток держит режим JPEG до отключения клиента; снимки присоединяются
+    // к нему, режим детекции восстанавливается после отключения
+    if (!cameraAcquire(OWNER_STREAM, PROFILE_STREAM, nullptr)) {
+        server.send(503, "text/plain", "Camera busy");
+        return;
+    }
+
     WiFiClient client = server.client();
     
     // Устанавливаем заголовки для MJPEG потока
@@ -193,23 +515,32 @@ void handleStream()
     response += "Access-Control-Allow-Origin: *\r\n";
     response += "\r\n";
     client.print(response);
-        
-    sensor_t *s = esp_camera_sensor_get();
-    // s->set_framesize(s, FRAMESIZE_QVGA);
-    s->set_pixformat(s, PIXFORMAT_JPEG);
 
     while (client.connected()) {
+        // Фото по срабатыванию важнее потока: камера уступается между кадрами
+        if (cameraPreempted(OWNER_STREAM)) {
+            cameraRelease(OWNER_STREAM);
+            if (!cameraAcquire(OWNER_STREAM, PROFILE_STREAM, nullptr))
+                return;
+        }
+
         // Захват кадра с камеры
-        camera_fb_t *fb = esp_camera_fb_get();
+        cameraLock();
+        camera_fb_t *fb = captureFreshFrame(settings.max_frame_age);
+        cameraUnlock();
         if (!fb) {
             Serial.println("Camera capture failed");
             break;
         }
+
+        uint32_t timestamp = frameCaptureTime(fb);
+        frameAgeRecord(webFrameAge, millis() - timestamp, settings.max_frame_age);
         
         // Формируем часть multipart ответа
         client.print("--frame\r\n");
         client.print("Content-Type: image/jpeg\r\n");
         client.printf("Content-Length: %d\r\n", fb->len);
+        client.printf("X-Timestamp: %u\r\n", (unsigned)timestamp);
         client.print("\r\n");
         client.write(fb->buf, fb->len);
         client.print("\r\n");
@@ -219,6 +550,8 @@ void handleStream()
         // Небольшая задержка для управления FPS
         delay(100); // ~10 FPS
     }
+
+    cameraRelease(OWNER_STREAM);
 }
 
 /**
@@ -306,6 +639,20 @@ void handleStream()
 // // // }
 
 
+/**
+ * @brief Возврат кадра снимка и освобождение камеры
+ *
+ * Камера отпускается только после возврата буфера: до этого арбитр не
+ * должен переключать сенсор, а задача захвата - брать кадры.
+ */
+static void finishSnapshot(camera_fb_t *fb)
+{
+    if (fb != NULL)
+        esp_camera_fb_return(fb);
+    cameraUnlock();
+    cameraRelease(OWNER_SNAPSHOT);
+}
+
 /**
  * @brief Улучшенный обработчик захвата кадра с защитой от битых изображений
  */
@@ -316,17 +663,27 @@ void handleCapture()
         return;
     }
     
-    sensor_t *s = esp_camera_sensor_get();
-    s->set_pixformat(s, PIXFORMAT_JPEG);
+    bool switched = false;
+    if (!cameraAcquire(OWNER_SNAPSHOT, PROFILE_STREAM, &switched)) {
+        server.send(503, "text/plain", "Camera busy");
+        return;
+    }
+    cameraLock();
     
-    vTaskDelay(200);
+    // Экспозиция ждётся, только если профиль сменился: снимок во время
+    // потока присоединяется к уже установившемуся режиму
+    if (switched) {
+        bool converged;
+        uint32_t settleMs = waitForExposure(settings.settle_max, settings.settle_tolerance, converged);
+        Serial.printf("Capture settled in %u ms%s\n", (unsigned)settleMs, converged ? "" : " (ceiling)");
+    }
 
     // Несколько попыток захвата кадра
     camera_fb_t* fb = NULL;
     int attempts = 3;
     
     for (int i = 0; i < attempts; i++) {
-        fb = esp_camera_fb_get();
+        fb = captureFreshFrame(settings.max_frame_age);
         if (fb != NULL && fb->len > 100) { // Минимальный размер для JPEG
             break;
         }
@@ -338,7 +695,7 @@ void handleCapture()
     }
     
     if (fb == NULL || fb->len <= 100) {
-        if (fb != NULL) esp_camera_fb_return(fb);
+        finishSnapshot(fb);
         
         // Возвращаем заглушку вместо ошибки
         const char* placeholder = R"rawliteral(
@@ -364,7 +721,7 @@ Connection: close
     
     // Проверяем, что это валидный JPEG (начинается с FF D8 FF)
     if (fb->len < 4 || fb->buf[0] != 0xFF || fb->buf[1] != 0xD8 || fb->buf[2] != 0xFF) {
-        esp_camera_fb_return(fb);
+        finishSnapshot(fb);
         
         // Возвращаем заглушку для невалидного JPEG
         const char* placeholder = R"rawliteral(
@@ -386,11 +743,17 @@ Connection: close
         return;
     }
     
-    // Отправляем корректный JPEG
+    // Отправляем корректный JPEG с меткой времени захвата
+    uint32_t timestamp = frameCaptureTime(fb);
+    uint32_t age = millis() - timestamp;
+    frameAgeRecord(webFrameAge, age, settings.max_frame_age);
+
     WiFiClient client = server.client();
     String headers = "HTTP/1.1 200 OK\r\n";
     headers += "Content-Type: image/jpeg\r\n";
     headers += "Content-Length: " + String(fb->len) + "\r\n";
+    headers += "X-Timestamp: " + String(timestamp) + "\r\n";
+    headers += "X-Frame-Age: " + String(age) + "\r\n";
     headers += "Cache-Control: no-cache, no-store, must-revalidate\r\n";
     headers += "Pragma: no-cache\r\n";
     headers += "Expires: 0\r\n";
@@ -400,6 +763,6 @@ Connection: close
     client.print(headers);
     client.write(fb->buf, fb->len);
     
-    esp_camera_fb_return(fb);
+    finishSnapshot(fb);
     client.stop();
 }
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include "Camera/CameraController.hpp"
 #include "Storage/SDCardManager.hpp"
 #include "Storage/PreferencesManager.hpp"
+#include "Storage/StorageWriter.hpp"
+#include "Storage/EventLog.hpp"
+#include "Storage/PhotoArchive.hpp"
+#include "Storage/Retention.hpp"
+#include "Storage/PhotoIndex.hpp"
 #include "Web/WebServerManager.hpp"
 #include "Sensors/DistanceSensor.hpp"
 #include "Detection/CarDetector.hpp"
@@ -27,6 +32,7 @@ bool camera_initialized = false;
 bool car_detected = false;
 unsigned long timeInterval = 0;
 unsigned long timeblink = 0;
+unsigned long timeVote = 0;
 
 /**
  * @brief Функция инициализации системы
@@ -44,6 +50,28 @@ void setup()
     loadSettings();
     updateROICoordinates();
 
+    // Фотографии записываются фоновой задачей, детекция её не ждёт;
+    // старые фотографии из корня карты переносятся в каталоги архива,
+    // их метаданные - в журнал событий, один раз; индекс галереи
+    // перестраивается, только если его нет или он испорчен
+    if (sd_initialized && eventLogOpen())
+        eventLogImportLegacy();
+    if (sd_initialized)
+    {
+        photoArchiveMigrate();
+        photoIndexOpen();
+        setupRetention();
+        startStorageTask();
+    }
+
+    // Режим камеры зависит от настроек, поэтому задача захвата стартует после них
+    if (camera_initialized)
+    {
+        switchToDetectionMode();
+        setupJpegHistory();
+        startCaptureTask();
+    }
+
     // Запуск точки доступа Wi-Fi
     WiFi.softAP(settings.ap_ssid.c_str(), settings.ap_password.c_str());
     IPAddress myIP = WiFi.softAPIP();
@@ -67,19 +95,30 @@ void loop()
 
     if (car_detected == true)
     {
-        if (lastDistance > resDistance + 50)
+        // Отъезд подтверждается автоматом зон, поэтому анализ продолжается
+        // в темпе свободной зоны; вспышка гасится и не мигает, пока не
+        // будет снят и проанализирован кадр без неё
+        bool voteDue = millis() > timeInterval + settings.interval && millis() > timeVote + 1000;
+        if (voteDue)
         {
             offFlash();
-            car_detected = false;
-        }
-        else
-        {
-            if (millis() > timeblink + 500)
+            if (detectCar())
             {
-                reverseFlash();
-                timeblink = millis();
+                timeVote = millis();
+                timeblink = timeVote;
+                voteDue = false;
             }
         }
+
+        if (car_detected == false)
+        {
+            offFlash();
+        }
+        else if (!voteDue && millis() > timeblink + 500)
+        {
+            reverseFlash();
+            timeblink = millis();
+        }
     }
     else
     {
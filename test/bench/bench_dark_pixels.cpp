@@ -0,0 +1,92 @@
+/**
+ * @file bench_dark_pixels.cpp
+ * @brief Замер подсчёта тёмных пикселей на кадре QQVGA 160x120
+ *
+ * Сравнивает словное ядро countDarkPixels() с побайтовым циклом, каким
+ * был исходный analyzeFrame(). Печатает нс и такты на пиксель; такты
+ * считаются по счётчику TSC и доступны только на x86.
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+// Число повторов замера
+#define BENCH_ITERATIONS 20000
+
+static uint8_t frame[DETECTION_FRAME_WIDTH * DETECTION_FRAME_HEIGHT];
+static volatile uint32_t sink;
+
+/**
+ * @brief Побайтовый подсчёт с проверкой границ на каждом пикселе
+ */
+static uint32_t scalarDarkCount(const uint8_t *image, int width, int x, int y, int w, int h, int threshold)
+{
+    uint32_t count = 0;
+    for (int row = y; row < y + h; row++)
+    {
+        for (int col = x; col < x + w; col++)
+        {
+            if (col >= width)
+                continue;
+            if (image[row * width + col] < threshold)
+                count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Прогон одного варианта и печать результата
+ */
+template <typename Kernel>
+static void run(const char *name, int x, int y, int w, int h, Kernel kernel)
+{
+    const double pixels = (double)w * h * BENCH_ITERATIONS;
+    auto start = std::chrono::steady_clock::now();
+#if HAVE_TSC
+    unsigned long long tscStart = __rdtsc();
+#endif
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+        sink += kernel(x, y, w, h, 100 + (i & 31));
+#if HAVE_TSC
+    unsigned long long tscEnd = __rdtsc();
+#endif
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+#if HAVE_TSC
+    printf("%-8s %3dx%-3d %7.3f ns/px %7.3f cycles/px\n", name, w, h, ns / pixels,
+           (double)(tscEnd - tscStart) / pixels);
+#else
+    printf("%-8s %3dx%-3d %7.3f ns/px\n", name, w, h, ns / pixels);
+#endif
+}
+
+int main()
+{
+    const int width = DETECTION_FRAME_WIDTH;
+    srand(1);
+    for (size_t i = 0; i < sizeof(frame); i++)
+        frame[i] = (uint8_t)rand();
+
+    // Вся рамка и область по умолчанию (80x60 со смещением 40,30)
+    const int areas[][4] = {{0, 0, DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT}, {40, 30, 80, 60}, {41, 30, 79, 60}};
+    for (const auto &a : areas)
+    {
+        run("scalar", a[0], a[1], a[2], a[3], [&](int x, int y, int w, int h, int t) {
+            return scalarDarkCount(frame, width, x, y, w, h, t);
+        });
+        run("swar", a[0], a[1], a[2], a[3], [&](int x, int y, int w, int h, int t) {
+            return countDarkPixels(frame, width, x, y, w, h, t);
+        });
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * @file bench_event_log.cpp
+ * @brief Замер записи метаданных событий: отдельные файлы и журнал
+ *
+ * Старая схема - файл car_NNNNN.json на событие, закрываемый после
+ * записи; журнал - записи EVENT_RECORD_SIZE байт в одном файле со сбросом
+ * на носитель каждые EVENT_LOG_SYNC_RECORDS записей. Печатается число
+ * событий в секунду для обеих схем.
+ *
+ *   bench_event_log [каталог [число событий]]
+ *
+ * По умолчанию используется временный каталог; для замера на карте
+ * памяти укажите каталог на ней.
+ */
+
+#include "Storage/EventLog.hpp"
+#include "Utils/Checksum.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+
+// Событий по умолчанию
+#define BENCH_EVENTS 2000
+
+/**
+ * @brief JSON события с теми же полями, что пишет saveZonePhotos()
+ */
+static std::string eventJson(int id)
+{
+    char json[512];
+    snprintf(json, sizeof(json),
+             "{\"id\":%d,\"image\":\"/events/%03d/car_%05d.jpg\",\"zone\":0,\"zoneRect\":[40,30,80,60],"
+             "\"totalPixels\":4800,\"darkPixels\":2431,\"whitePixels\":2369,\"darkRatio\":0.506,"
+             "\"texture\":318.4,\"threshold\":112,\"blob\":{\"area\":2207,\"bbox\":[41,33,58,47],"
+             "\"centroid\":[69.5,56.2]},\"luma\":{\"mean\":104.2,\"variance\":2841.7,\"p10\":21,"
+             "\"p50\":96,\"p90\":201},\"distance\":212,\"settle_ms\":180,\"uptime_ms\":%d}",
+             id, id / 100, id, 1000 + id * 5000);
+    return json;
+}
+
+static double writeFiles(const std::string &dir, int events)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int id = 1; id <= events; id++)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/car_%05d.json", dir.c_str(), id);
+        std::string json = eventJson(id);
+        FILE *file = fopen(path, "w");
+        if (!file)
+            return 0;
+        fwrite(json.data(), 1, json.size(), file);
+        fflush(file);
+        fsync(fileno(file));
+        fclose(file);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static double writeLog(const std::string &dir, int events)
+{
+    static uint8_t record[EVENT_RECORD_SIZE];
+    std::string path = dir + "/events.log";
+    auto start = std::chrono::steady_clock::now();
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return 0;
+
+    for (int id = 1; id <= events; id++)
+    {
+        std::string json = eventJson(id);
+        EventRecordHeader header;
+        header.magic = EVENT_RECORD_MAGIC;
+        header.id = id;
+        header.length = json.size();
+        header.checksum = fletcher16((const uint8_t *)json.data(), json.size());
+        header.reserved = 0;
+
+        memset(record, '\n', sizeof(record));
+        memcpy(record, &header, sizeof(header));
+        memcpy(record + sizeof(header), json.data(), json.size());
+        fwrite(record, 1, sizeof(record), file);
+        if (id % EVENT_LOG_SYNC_RECORDS == 0)
+        {
+            fflush(file);
+            fsync(fileno(file));
+        }
+    }
+    fflush(file);
+    fsync(fileno(file));
+    fclose(file);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static void removeFiles(const std::string &dir, int events)
+{
+    for (int id = 1; id <= events; id++)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/car_%05d.json", dir.c_str(), id);
+        remove(path);
+    }
+    remove((dir + "/events.log").c_str());
+}
+
+int main(int argc, char **argv)
+{
+    std::string dir;
+    bool temporary = argc < 2;
+    if (temporary)
+    {
+        char pattern[] = "/tmp/bench_event_log.XXXXXX";
+        if (!mkdtemp(pattern))
+        {
+            perror("mkdtemp");
+            return 1;
+        }
+        dir = pattern;
+    }
+    else
+    {
+        dir = argv[1];
+    }
+    int events = argc > 2 ? atoi(argv[2]) : BENCH_EVENTS;
+
+    double files = writeFiles(dir, events);
+    double log = writeLog(dir, events);
+    removeFiles(dir, events);
+    if (temporary)
+        rmdir(dir.c_str());
+
+    if (files <= 0 || log <= 0)
+    {
+        fprintf(stderr, "Cannot write to %s\n", dir.c_str());
+        return 1;
+    }
+    printf("%d events in %s\n", events, dir.c_str());
+    printf("per-file json  %8.0f events/s\n", events / files);
+    printf("event log      %8.0f events/s (sync every %d)\n", events / log, EVENT_LOG_SYNC_RECORDS);
+    return 0;
+}
\ No newline at end of file
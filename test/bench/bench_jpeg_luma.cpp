@@ -0,0 +1,189 @@
+/**
+ * @file bench_jpeg_luma.cpp
+ * @brief Замер получения кадра детекции из JPEG SVGA
+ *
+ * jpegToLuma() декодирует кадр SVGA 800x600 с уменьшением и выбирает
+ * яркость в сетку кадра детекции. Кадр - фиксированная сцена (асфальт,
+ * разметка, тёмный автомобиль), сжатая libjpeg с прореживанием цвета
+ * 4:2:2, как у OV2640; вместо неё можно передать файл JPEG с камеры.
+ * Замер печатает время на кадр для кадра детекции и для 100x75 и
+ * среднее отклонение яркости от исходной сцены.
+ *
+ * Декодирует libjpeg, а не tjpgd устройства: абсолютное время только
+ * ориентир, сравнивать имеет смысл размеры и масштабы между собой.
+ */
+
+#include "Camera/JpegLuma.hpp"
+#include "Detection/FrameKernels.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+#include <jpeglib.h>
+
+// Кадр однорежимного конвейера
+#define SOURCE_WIDTH 800
+#define SOURCE_HEIGHT 600
+
+// Качество сжатия сцены, близкое к jpeg_quality 12 сенсора
+#define SOURCE_QUALITY 80
+
+// Число повторов замера
+#define BENCH_ITERATIONS 200
+
+static volatile uint8_t sink;
+
+/**
+ * @brief Яркость фиксированной сцены SVGA
+ */
+static void buildScene(std::vector<uint8_t> &luma)
+{
+    luma.resize(SOURCE_WIDTH * SOURCE_HEIGHT);
+    srand(1);
+    for (int y = 0; y < SOURCE_HEIGHT; y++)
+    {
+        for (int x = 0; x < SOURCE_WIDTH; x++)
+        {
+            // Асфальт с перепадом освещённости и зерном
+            int value = 110 + x / 20 - y / 30 + rand() % 17 - 8;
+
+            // Линия разметки и автомобиль
+            if (x >= 380 && x < 396)
+                value = 215;
+            if (x >= 220 && x < 560 && y >= 200 && y < 470)
+                value = 35 + ((x / 40 + y / 30) % 2) * 20;
+            luma[y * SOURCE_WIDTH + x] = (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+        }
+    }
+}
+
+/**
+ * @brief Сжатие сцены в JPEG с прореживанием цвета 4:2:2
+ */
+static std::vector<uint8_t> compressScene(const std::vector<uint8_t> &luma)
+{
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+
+    unsigned char *out = nullptr;
+    unsigned long outSize = 0;
+    jpeg_mem_dest(&cinfo, &out, &outSize);
+
+    cinfo.image_width = SOURCE_WIDTH;
+    cinfo.image_height = SOURCE_HEIGHT;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, SOURCE_QUALITY, TRUE);
+    cinfo.comp_info[0].h_samp_factor = 2;
+    cinfo.comp_info[0].v_samp_factor = 1;
+    jpeg_start_compress(&cinfo, TRUE);
+
+    std::vector<uint8_t> row(SOURCE_WIDTH * 3);
+    while (cinfo.next_scanline < cinfo.image_height)
+    {
+        const uint8_t *src = luma.data() + cinfo.next_scanline * SOURCE_WIDTH;
+        for (int x = 0; x < SOURCE_WIDTH; x++)
+            row[x * 3] = row[x * 3 + 1] = row[x * 3 + 2] = src[x];
+        JSAMPROW rows[1] = {row.data()};
+        jpeg_write_scanlines(&cinfo, rows, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    std::vector<uint8_t> jpeg(out, out + outSize);
+    free(out);
+    return jpeg;
+}
+
+/**
+ * @brief Чтение файла JPEG и его ширины
+ */
+static bool readJpegFile(const char *path, std::vector<uint8_t> &jpeg, int &width)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return false;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        jpeg.insert(jpeg.end(), chunk, chunk + n);
+    fclose(file);
+
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, jpeg.data(), (unsigned long)jpeg.size());
+    jpeg_read_header(&cinfo, TRUE);
+    width = cinfo.image_width;
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+/**
+ * @brief Среднее отклонение яркости кадра от исходной сцены в тех же точках
+ */
+static double lumaError(const std::vector<uint8_t> &scene, const uint8_t *out, int width, int height)
+{
+    double sum = 0;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int sx = x * SOURCE_WIDTH / width;
+            int sy = y * SOURCE_HEIGHT / height;
+            sum += abs(out[y * width + x] - scene[sy * SOURCE_WIDTH + sx]);
+        }
+    }
+    return sum / (width * height);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<uint8_t> scene;
+    std::vector<uint8_t> jpeg;
+    int sourceWidth = SOURCE_WIDTH;
+    if (argc > 1)
+    {
+        if (!readJpegFile(argv[1], jpeg, sourceWidth))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        buildScene(scene);
+        jpeg = compressScene(scene);
+    }
+    printf("jpeg    %d px wide, %zu bytes\n", sourceWidth, jpeg.size());
+
+    const int sizes[][2] = {{DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT}, {100, 75}};
+    for (const auto &size : sizes)
+    {
+        std::vector<uint8_t> out(size[0] * size[1]);
+        if (!jpegToLuma(jpeg.data(), jpeg.size(), sourceWidth, out.data(), size[0], size[1]))
+        {
+            fprintf(stderr, "decode failed\n");
+            return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_ITERATIONS; i++)
+        {
+            jpegToLuma(jpeg.data(), jpeg.size(), sourceWidth, out.data(), size[0], size[1]);
+            sink += out[i % out.size()];
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count() / BENCH_ITERATIONS;
+
+        printf("%3dx%-3d %7.3f ms", size[0], size[1], ms);
+        if (!scene.empty())
+            printf("  error %.1f", lumaError(scene, out.data(), size[0], size[1]));
+        printf("\n");
+    }
+    return 0;
+}
\ No newline at end of file
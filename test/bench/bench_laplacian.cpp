@@ -0,0 +1,69 @@
+/**
+ * @file bench_laplacian.cpp
+ * @brief Замер оценки резкости кадров серии
+ *
+ * laplacianVariance() считается по яркости JPEG SVGA, уменьшенной в 8 раз
+ * (100x75) или, при burst_fine, в 4 раза (200x150). Замер печатает время
+ * оценки для обоих размеров и оценки резкого и размытого (3x3) кадра:
+ * размытый должен получать заметно меньшую оценку.
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+// Яркость SVGA 800x600, уменьшенная в 4 раза
+#define LUMA_WIDTH 200
+#define LUMA_HEIGHT 150
+
+// Число повторов замера
+#define BENCH_ITERATIONS 20000
+
+static uint8_t sharp[LUMA_WIDTH * LUMA_HEIGHT];
+static uint8_t blurred[LUMA_WIDTH * LUMA_HEIGHT];
+static volatile float sink;
+
+/**
+ * @brief Размытие 3x3 средним, края копируются как есть
+ */
+static void boxBlur(const uint8_t *src, uint8_t *dst, int width, int height)
+{
+    for (int i = 0; i < width * height; i++)
+        dst[i] = src[i];
+
+    for (int y = 1; y < height - 1; y++)
+    {
+        for (int x = 1; x < width - 1; x++)
+        {
+            int sum = 0;
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                    sum += src[(y + dy) * width + x + dx];
+            dst[y * width + x] = (uint8_t)(sum / 9);
+        }
+    }
+}
+
+int main()
+{
+    srand(1);
+    for (size_t i = 0; i < sizeof(sharp); i++)
+        sharp[i] = (uint8_t)rand();
+    boxBlur(sharp, blurred, LUMA_WIDTH, LUMA_HEIGHT);
+
+    printf("score   sharp %.0f  blurred %.0f\n", laplacianVariance(sharp, LUMA_WIDTH, LUMA_HEIGHT),
+           laplacianVariance(blurred, LUMA_WIDTH, LUMA_HEIGHT));
+
+    const int sizes[][2] = {{LUMA_WIDTH / 2, LUMA_HEIGHT / 2}, {LUMA_WIDTH, LUMA_HEIGHT}};
+    for (const auto &size : sizes)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCH_ITERATIONS; i++)
+            sink += laplacianVariance(sharp, size[0], size[1]);
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() / BENCH_ITERATIONS;
+        printf("%3dx%-3d %7.2f us %6.3f ns/px\n", size[0], size[1], us, us * 1000.0 / (size[0] * size[1]));
+    }
+    return 0;
+}
\ No newline at end of file
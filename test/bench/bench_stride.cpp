@@ -0,0 +1,122 @@
+/**
+ * @file bench_stride.cpp
+ * @brief Замер анализа с прореживанием: ускорение и отклонение доли тёмных
+ *
+ * Для шагов 1, 2 и 4 печатает время подсчёта тёмных пикселей зоны 80x60
+ * (с прореживанием для шагов 2 и 4) и отклонение darkRatio от полного
+ * подсчёта. Кадры берутся из файлов .pgm или сырых дампов 160x120,
+ * переданных в командной строке; без аргументов используются
+ * синтетические кадры с тёмным прямоугольником.
+ *
+ *   bench_stride frames/*.pgm
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include "PgmFile.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+// Повторов замера времени на кадр
+#define BENCH_REPEATS 200
+
+/**
+ * @brief Синтетические кадры: тёмный прямоугольник случайного размера на светлом фоне
+ */
+static void syntheticFrames(std::vector<GrayFrame> &frames)
+{
+    srand(4);
+    for (int n = 0; n < 100; n++)
+    {
+        GrayFrame frame;
+        frame.width = DETECTION_FRAME_WIDTH;
+        frame.height = DETECTION_FRAME_HEIGHT;
+        frame.pixels.resize(frame.width * frame.height);
+        int cx = rand() % frame.width;
+        int cy = rand() % frame.height;
+        int halfWidth = 5 + rand() % 30;
+        int halfHeight = 5 + rand() % 20;
+        for (int y = 0; y < frame.height; y++)
+        {
+            for (int x = 0; x < frame.width; x++)
+            {
+                bool car = abs(x - cx) < halfWidth && abs(y - cy) < halfHeight;
+                frame.pixels[y * frame.width + x] = (uint8_t)(car ? 40 + rand() % 40 : 150 + rand() % 40);
+            }
+        }
+        frames.push_back(frame);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<GrayFrame> frames;
+    for (int i = 1; i < argc; i++)
+    {
+        GrayFrame frame;
+        if (readGrayFrame(argv[i], frame) && frame.width == DETECTION_FRAME_WIDTH &&
+            frame.height == DETECTION_FRAME_HEIGHT)
+            frames.push_back(frame);
+        else
+            fprintf(stderr, "Skipped %s\n", argv[i]);
+    }
+    if (frames.empty())
+        syntheticFrames(frames);
+
+    const int width = DETECTION_FRAME_WIDTH;
+    const int zoneX = 40, zoneY = 30, zoneWidth = 80, zoneHeight = 60, threshold = 128;
+    std::vector<uint8_t> out(width * DETECTION_FRAME_HEIGHT);
+    volatile uint32_t sink = 0;
+    double baseUs = 0;
+
+    printf("%zu frames\n", frames.size());
+    for (int step = 1; step <= 4; step *= 2)
+    {
+        const int outWidth = (width + step - 1) / step;
+        PixelRect zone;
+        zone.x = (zoneX + step - 1) / step;
+        zone.y = (zoneY + step - 1) / step;
+        zone.width = (zoneX + zoneWidth + step - 1) / step - zone.x;
+        zone.height = (zoneY + zoneHeight + step - 1) / step - zone.y;
+        zone.threshold = threshold;
+
+        double sumDeviation = 0;
+        double maxDeviation = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const GrayFrame &frame : frames)
+        {
+            const uint8_t *image = frame.pixels.data();
+            double full = countDarkPixels(image, width, zoneX, zoneY, zoneWidth, zoneHeight, threshold) /
+                          (double)(zoneWidth * zoneHeight);
+
+            uint32_t count = 0;
+            for (int r = 0; r < BENCH_REPEATS; r++)
+            {
+                if (step > 1)
+                {
+                    decimateFrame(image, width, step, zone, out.data(), outWidth);
+                    count = countDarkPixels(out.data(), outWidth, zone.x, zone.y, zone.width, zone.height, threshold);
+                }
+                else
+                {
+                    count = countDarkPixels(image, width, zoneX, zoneY, zoneWidth, zoneHeight, threshold);
+                }
+                sink += count;
+            }
+
+            double deviation = fabs(count / (double)(zone.width * zone.height) - full);
+            sumDeviation += deviation;
+            maxDeviation = fmax(maxDeviation, deviation);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double us = std::chrono::duration<double, std::micro>(end - start).count() / (frames.size() * BENCH_REPEATS);
+        if (step == 1)
+            baseUs = us;
+        printf("step %d: %6.2f us/frame, speed-up %.2fx, darkRatio deviation mean %.4f max %.4f\n", step, us,
+               baseUs / us, sumDeviation / frames.size(), maxDeviation);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+/**
+ * @file bench_texture.cpp
+ * @brief Замер совмещённого ядра тёмных пикселей и текстуры
+ *
+ * Сравнивает analyzeRegionsTexture() с подсчётом только тёмных пикселей
+ * (прежний цикл детекции) и с двумя раздельными проходами: подсчёт и
+ * отдельный обход зоны для градиентной энергии.
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+// Число повторов замера
+#define BENCH_ITERATIONS 5000
+
+static uint8_t frame[DETECTION_FRAME_WIDTH * DETECTION_FRAME_HEIGHT];
+static volatile float sink;
+
+/**
+ * @brief Отдельный проход по зоне для градиентной энергии
+ */
+static float separateTexture(const uint8_t *image, int width, const PixelRect &r)
+{
+    uint64_t energy = 0;
+    for (int y = r.y; y < r.y + r.height; y++)
+    {
+        for (int x = r.x; x < r.x + r.width; x++)
+        {
+            int p = image[y * width + x];
+            if (x + 1 < r.x + r.width)
+                energy += (image[y * width + x + 1] - p) * (image[y * width + x + 1] - p);
+            if (y + 1 < r.y + r.height)
+                energy += (image[(y + 1) * width + x] - p) * (image[(y + 1) * width + x] - p);
+        }
+    }
+    return (float)energy / (r.width * r.height);
+}
+
+/**
+ * @brief Прогон одного варианта: мкс на кадр и нс на пиксель зоны
+ */
+template <typename Kernel>
+static void run(const char *name, const PixelRect &zone, Kernel kernel)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+        kernel();
+    auto end = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(end - start).count() / BENCH_ITERATIONS;
+    printf("%-10s %3dx%-3d %8.2f us/frame %6.3f ns/px\n", name, zone.width, zone.height, us,
+           us * 1000.0 / (zone.width * zone.height));
+}
+
+int main()
+{
+    const int width = DETECTION_FRAME_WIDTH;
+    srand(1);
+    for (size_t i = 0; i < sizeof(frame); i++)
+        frame[i] = (uint8_t)rand();
+
+    const PixelRect zones[] = {{40, 30, 80, 60, 128}, {0, 0, DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT, 128}};
+    for (const PixelRect &zone : zones)
+    {
+        uint32_t count;
+        float texture;
+        run("dark", zone, [&]() {
+            countDarkPixelsRegions(frame, width, &zone, 1, &count);
+            sink = count;
+        });
+        run("two-pass", zone, [&]() {
+            countDarkPixelsRegions(frame, width, &zone, 1, &count);
+            sink = count + separateTexture(frame, width, zone);
+        });
+        run("fused", zone, [&]() {
+            analyzeRegionsTexture(frame, width, &zone, 1, &count, &texture, nullptr);
+            sink = count + texture;
+        });
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * @file PgmFile.hpp
+ * @brief Чтение записанных полутоновых кадров
+ *
+ * Поддерживаются двоичный PGM (P5, maxval до 255) и сырой дамп без
+ * заголовка, размер которого задаётся явно (160x120 по умолчанию).
+ */
+
+#ifndef PGM_FILE_HPP
+#define PGM_FILE_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @brief Полутоновый кадр
+ */
+struct GrayFrame
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * @brief Следующее число заголовка PGM с пропуском комментариев
+ */
+static inline bool pgmReadNumber(FILE *file, int &value)
+{
+    int c = fgetc(file);
+    while (c != EOF)
+    {
+        if (c == '#')
+        {
+            while (c != EOF && c != '\n')
+                c = fgetc(file);
+        }
+        else if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+        {
+            break;
+        }
+        c = fgetc(file);
+    }
+    if (c < '0' || c > '9')
+        return false;
+
+    value = 0;
+    while (c >= '0' && c <= '9')
+    {
+        value = value * 10 + (c - '0');
+        c = fgetc(file);
+    }
+    // Один пробельный символ после maxval отделяет данные
+    return true;
+}
+
+/**
+ * @brief Чтение кадра из файла .pgm или сырого дампа
+ * @param rawWidth, rawHeight Размер сырого дампа (файлы не .pgm)
+ */
+static inline bool readGrayFrame(const char *path, GrayFrame &frame, int rawWidth = 160, int rawHeight = 120)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    size_t length = strlen(path);
+    bool pgm = length > 4 && strcmp(path + length - 4, ".pgm") == 0;
+    bool ok = true;
+    int maxval = 255;
+
+    if (pgm)
+    {
+        ok = fgetc(file) == 'P' && fgetc(file) == '5' && pgmReadNumber(file, frame.width) &&
+             pgmReadNumber(file, frame.height) && pgmReadNumber(file, maxval) && maxval > 0 && maxval < 256;
+    }
+    else
+    {
+        frame.width = rawWidth;
+        frame.height = rawHeight;
+    }
+
+    if (ok && frame.width > 0 && frame.height > 0)
+    {
+        frame.pixels.resize((size_t)frame.width * frame.height);
+        ok = fread(frame.pixels.data(), 1, frame.pixels.size(), file) == frame.pixels.size();
+    }
+    else
+    {
+        ok = false;
+    }
+
+    fclose(file);
+    return ok;
+}
+
+#endif // PGM_FILE_HPP
\ No newline at end of file
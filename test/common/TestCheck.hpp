@@ -0,0 +1,49 @@
+/**
+ * @file TestCheck.hpp
+ * @brief Проверки для модульных тестов, собираемых на хосте
+ *
+ * Проверка не прерывает тест: печатается место и выражение, а код
+ * возврата теста складывается из числа неудачных проверок.
+ */
+
+#ifndef TEST_CHECK_HPP
+#define TEST_CHECK_HPP
+
+#include <stdio.h>
+
+// Число неудачных проверок теста
+static int testFailures = 0;
+
+#define CHECK(cond)                                                         \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                             \
+    do                                                                             \
+    {                                                                              \
+        long long _a = (long long)(a);                                             \
+        long long _b = (long long)(b);                                             \
+        if (_a != _b)                                                              \
+        {                                                                          \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__,     \
+                   __LINE__, #a, #b, _a, _b);                                      \
+            testFailures++;                                                        \
+        }                                                                          \
+    } while (0)
+
+/**
+ * @brief Итог теста: код возврата для ctest
+ */
+static inline int testResult(const char *name)
+{
+    printf("%s: %s\n", name, testFailures ? "FAILED" : "OK");
+    return testFailures ? 1 : 0;
+}
+
+#endif // TEST_CHECK_HPP
\ No newline at end of file
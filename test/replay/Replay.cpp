@@ -0,0 +1,328 @@
+/**
+ * @file Replay.cpp
+ * @brief Воспроизведение записанных кадров через код детекции на хосте
+ *
+ * Кадры подаются через заглушку esp_camera_fb_get() в тот же путь, что и
+ * на устройстве: фильтр статичных кадров, анализ зон и автомат занятости
+ * (detectInFrame()). Для каждого кадра печатается решение по зонам, в
+ * конце - пропускная способность анализа в кадрах в секунду.
+ *
+ *   replay [-v] [-s key=value]... [-z x,y,w,h[,threshold[,area]]]... [-d distance] trace.txt
+ *   replay [-v] [-s key=value]... [-d distance] frame0.pgm frame1.raw ...
+ *
+ * Трасса - текстовый файл, строка на кадр: путь к кадру (.pgm или сырой
+ * дамп 160x120) и показание датчика расстояния; пути считаются от
+ * каталога трассы, строки с # пропускаются. Кадр без расстояния получает
+ * значение -d (по умолчанию 100).
+ */
+
+#include "Detection/FrameAnalyzer.hpp"
+#include "Config/Config.hpp"
+#include "PgmFile.hpp"
+#include <esp_camera.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Настройки, которые на устройстве читаются из settings.json
+Settings settings;
+
+namespace
+{
+    /**
+     * @brief Записанный кадр с показанием датчика расстояния
+     */
+    struct ReplayFrame
+    {
+        std::string name;
+        GrayFrame image;
+        int distance;
+    };
+
+    std::vector<ReplayFrame> frames;
+    size_t nextFrame = 0;
+    camera_fb_t frameBuffer;
+
+    /**
+     * @brief Числовая настройка, задаваемая через -s key=value
+     */
+    struct SettingField
+    {
+        const char *key;
+        int *intValue;
+        float *floatValue;
+        bool *boolValue;
+    };
+
+    const SettingField settingFields[] = {
+        {"distance", &settings.distance, nullptr, nullptr},
+        {"threshold", &settings.threshold, nullptr, nullptr},
+        {"area", &settings.area, nullptr, nullptr},
+        {"dark_min", nullptr, &settings.dark_min, nullptr},
+        {"dark_max", nullptr, &settings.dark_max, nullptr},
+        {"texture", nullptr, &settings.texture, nullptr},
+        {"integral_mode", &settings.integral_mode, nullptr, nullptr},
+        {"background", nullptr, nullptr, &settings.background},
+        {"bg_shift", &settings.bg_shift, nullptr, nullptr},
+        {"fg_threshold", &settings.fg_threshold, nullptr, nullptr},
+        {"motion_gate", &settings.motion_gate, nullptr, nullptr},
+        {"blob", nullptr, nullptr, &settings.blob},
+        {"stride", &settings.stride, nullptr, nullptr},
+        {"confirm_n", &settings.confirm_n, nullptr, nullptr},
+        {"confirm_m", &settings.confirm_m, nullptr, nullptr},
+    };
+
+    bool setSetting(const char *assignment)
+    {
+        const char *eq = strchr(assignment, '=');
+        if (!eq)
+            return false;
+
+        std::string key(assignment, eq - assignment);
+        for (const SettingField &field : settingFields)
+        {
+            if (key != field.key)
+                continue;
+            if (field.intValue)
+                *field.intValue = atoi(eq + 1);
+            else if (field.floatValue)
+                *field.floatValue = (float)atof(eq + 1);
+            else
+                *field.boolValue = atoi(eq + 1) != 0;
+            return true;
+        }
+        return false;
+    }
+
+    bool addZone(const char *spec)
+    {
+        if (settings.zone_count >= MAX_DETECTION_ZONES)
+            return false;
+
+        DetectionZone zone;
+        zone.threshold = settings.threshold;
+        zone.area = settings.area;
+        int fields = sscanf(spec, "%d,%d,%d,%d,%d,%d", &zone.x, &zone.y, &zone.width, &zone.height, &zone.threshold,
+                            &zone.area);
+        if (fields < 4)
+            return false;
+
+        settings.zones[settings.zone_count++] = zone;
+        return true;
+    }
+
+    bool loadFrame(const std::string &path, int distance)
+    {
+        ReplayFrame frame;
+        frame.name = path;
+        frame.distance = distance;
+        if (!readGrayFrame(path.c_str(), frame.image))
+        {
+            fprintf(stderr, "Cannot read frame %s\n", path.c_str());
+            return false;
+        }
+        frames.push_back(frame);
+        return true;
+    }
+
+    bool loadTrace(const char *path, int defaultDistance)
+    {
+        FILE *file = fopen(path, "r");
+        if (!file)
+        {
+            fprintf(stderr, "Cannot open trace %s\n", path);
+            return false;
+        }
+
+        std::string dir(path);
+        size_t slash = dir.rfind('/');
+        dir = slash == std::string::npos ? "" : dir.substr(0, slash + 1);
+
+        char line[1024];
+        bool ok = true;
+        while (ok && fgets(line, sizeof(line), file))
+        {
+            char name[1024];
+            int distance = defaultDistance;
+            if (line[0] == '#' || sscanf(line, "%1023s %d", name, &distance) < 1)
+                continue;
+            ok = loadFrame(name[0] == '/' ? std::string(name) : dir + name, distance);
+        }
+        fclose(file);
+        return ok;
+    }
+
+    void usage()
+    {
+        fprintf(stderr,
+                "usage: replay [-v] [-s key=value]... [-z x,y,w,h[,threshold[,area]]]... [-d distance]\n"
+                "              trace.txt | frame.pgm...\n");
+    }
+}
+
+/**
+ * @brief Следующий записанный кадр вместо кадра сенсора
+ */
+camera_fb_t *esp_camera_fb_get()
+{
+    if (nextFrame >= frames.size())
+        return nullptr;
+
+    GrayFrame &image = frames[nextFrame++].image;
+    frameBuffer.buf = image.pixels.data();
+    frameBuffer.len = image.pixels.size();
+    frameBuffer.width = image.width;
+    frameBuffer.height = image.height;
+    frameBuffer.format = PIXFORMAT_GRAYSCALE;
+    return &frameBuffer;
+}
+
+void esp_camera_fb_return(camera_fb_t *)
+{
+}
+
+int main(int argc, char **argv)
+{
+    int defaultDistance = 100;
+    bool zonesGiven = false;
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++)
+    {
+        const char *option = argv[arg];
+        const char *value = arg + 1 < argc ? argv[arg + 1] : nullptr;
+        if (strcmp(option, "-v") == 0)
+        {
+            hostSerialEcho = true;
+            continue;
+        }
+        if (!value)
+        {
+            usage();
+            return 2;
+        }
+
+        arg++;
+        bool ok = true;
+        if (strcmp(option, "-s") == 0)
+        {
+            ok = setSetting(value);
+        }
+        else if (strcmp(option, "-z") == 0)
+        {
+            if (!zonesGiven)
+                settings.zone_count = 0;
+            zonesGiven = true;
+            ok = addZone(value);
+        }
+        else if (strcmp(option, "-d") == 0)
+        {
+            defaultDistance = atoi(value);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            fprintf(stderr, "Bad option %s %s\n", option, value);
+            usage();
+            return 2;
+        }
+    }
+    if (arg >= argc)
+    {
+        usage();
+        return 2;
+    }
+
+    // Зона 0 совпадает с ROI, как после updateROICoordinates() на устройстве
+    if (!zonesGiven)
+    {
+        DetectionZone &primary = settings.zones[0];
+        primary.x = settings.roi_x;
+        primary.y = settings.roi_y;
+        primary.width = settings.roi_width;
+        primary.height = settings.roi_height;
+        primary.threshold = settings.threshold;
+        primary.area = settings.area;
+        settings.zone_count = 1;
+    }
+
+    size_t length = strlen(argv[arg]);
+    bool trace = argc - arg == 1 && length > 4 && strcmp(argv[arg] + length - 4, ".txt") == 0;
+    if (trace)
+    {
+        if (!loadTrace(argv[arg], defaultDistance))
+            return 1;
+    }
+    else
+    {
+        for (; arg < argc; arg++)
+        {
+            if (!loadFrame(argv[arg], defaultDistance))
+                return 1;
+        }
+    }
+
+    resetZones();
+    double analysisSeconds = 0;
+    int analyzedFrames = 0;
+    int arrivals = 0;
+    int departures = 0;
+
+    for (size_t index = 0;; index++)
+    {
+        camera_fb_t *fb = esp_camera_fb_get();
+        if (!fb)
+            break;
+        const ReplayFrame &frame = frames[index];
+
+        bool wasOccupied[MAX_DETECTION_ZONES];
+        for (int i = 0; i < settings.zone_count; i++)
+            wasOccupied[i] = zoneStates[i].occupied;
+
+        bool analyzed = false;
+        auto start = std::chrono::steady_clock::now();
+        uint32_t triggered = detectInFrame(fb->buf, fb->width, fb->height, frame.distance, analyzed);
+        auto end = std::chrono::steady_clock::now();
+        esp_camera_fb_return(fb);
+
+        analysisSeconds += std::chrono::duration<double>(end - start).count();
+        printf("%4zu %s distance %d:", index, frame.name.c_str(), frame.distance);
+        if (!analyzed)
+        {
+            printf(" unchanged\n");
+            continue;
+        }
+
+        analyzedFrames++;
+        for (int i = 0; i < settings.zone_count; i++)
+        {
+            const ZoneState &state = zoneStates[i];
+            const char *event = "";
+            if (triggered & (1u << i))
+            {
+                event = " ARRIVED";
+                arrivals++;
+            }
+            else if (wasOccupied[i] && !state.occupied)
+            {
+                event = " DEPARTED";
+                departures++;
+            }
+            printf(" | zone %d %s vote %d ratio %.3f dark %d threshold %d texture %.1f%s", i,
+                   occupancyStateName(state.tracker.state), state.vote ? 1 : 0, state.darkRatio, state.darkPixels,
+                   state.threshold, state.texture, event);
+        }
+        printf("\n");
+    }
+
+    printf("%zu frames, %d analyzed, %d arrivals, %d departures, %.3f ms analysis, %.0f frames/s\n", frames.size(),
+           analyzedFrames, arrivals, departures, analysisSeconds * 1000.0,
+           analysisSeconds > 0 ? frames.size() / analysisSeconds : 0.0);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+/**
+ * @file Arduino.cpp
+ * @brief Реализация заглушки Arduino на хосте
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <thread>
+
+bool hostSerialEcho = false;
+HardwareSerial Serial;
+
+namespace
+{
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+}
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
\ No newline at end of file
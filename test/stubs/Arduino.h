@@ -0,0 +1,75 @@
+/**
+ * @file Arduino.h
+ * @brief Заглушка Arduino для сборки модулей анализа на хосте
+ *
+ * Содержит только то, чем пользуются модули, собираемые в test/:
+ * String для полей Settings, Serial, min/max, constrain и время.
+ * Вывод Serial печатается в stdout, только если hostSerialEcho.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/**
+ * @brief Строка Arduino поверх std::string
+ */
+class String
+{
+public:
+    String() {}
+    String(const char *text) : value(text ? text : "") {}
+    const char *c_str() const { return value.c_str(); }
+    unsigned length() const { return (unsigned)value.size(); }
+    bool operator==(const String &other) const { return value == other.value; }
+
+private:
+    std::string value;
+};
+
+// Печатать ли вывод Serial в stdout
+extern bool hostSerialEcho;
+
+/**
+ * @brief Последовательный порт: вывод в stdout или никуда
+ */
+class HardwareSerial
+{
+public:
+    void begin(unsigned long) {}
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        if (!hostSerialEcho)
+            return 0;
+        va_list args;
+        va_start(args, format);
+        int written = vprintf(format, args);
+        va_end(args);
+        return written > 0 ? (size_t)written : 0;
+    }
+
+    size_t println(const char *text) { return hostSerialEcho ? (size_t)::printf("%s\n", text) : 0; }
+    size_t println(const String &text) { return println(text.c_str()); }
+};
+
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+#endif // HOST_ARDUINO_H
\ No newline at end of file
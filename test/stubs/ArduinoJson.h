@@ -0,0 +1,14 @@
+/**
+ * @file ArduinoJson.h
+ * @brief Заглушка ArduinoJson: модули, собираемые на хосте, JSON не используют
+ *
+ * Config.hpp включает ArduinoJson.h, но объявляет только структуры
+ * настроек; чтение и запись settings.json на хосте не собираются.
+ */
+
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+#include <Arduino.h>
+
+#endif // HOST_ARDUINO_JSON_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+/**
+ * @file esp_camera.h
+ * @brief Заглушка драйвера камеры для воспроизведения записанных кадров
+ *
+ * Буфер кадра повторяет camera_fb_t драйвера esp32-camera;
+ * esp_camera_fb_get() и esp_camera_fb_return() реализует источник
+ * кадров хостовой программы (test/replay).
+ */
+
+#ifndef HOST_ESP_CAMERA_H
+#define HOST_ESP_CAMERA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+typedef enum
+{
+    PIXFORMAT_RGB565,
+    PIXFORMAT_YUV422,
+    PIXFORMAT_GRAYSCALE,
+    PIXFORMAT_JPEG,
+    PIXFORMAT_RGB888
+} pixformat_t;
+
+typedef struct
+{
+    uint8_t *buf;
+    size_t len;
+    size_t width;
+    size_t height;
+    pixformat_t format;
+    struct timeval timestamp;
+} camera_fb_t;
+
+camera_fb_t *esp_camera_fb_get();
+void esp_camera_fb_return(camera_fb_t *fb);
+
+#endif // HOST_ESP_CAMERA_H
\ No newline at end of file
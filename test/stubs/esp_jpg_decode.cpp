@@ -0,0 +1,111 @@
+/**
+ * @file esp_jpg_decode.cpp
+ * @brief Реализация заглушки декодера JPEG через libjpeg
+ */
+
+#include <esp_jpg_decode.h>
+#include <stdio.h>
+#include <setjmp.h>
+#include <string.h>
+#include <vector>
+#include <jpeglib.h>
+
+// Размер порции чтения, как у буфера tjpgd в драйвере
+#define JPG_READ_CHUNK 512
+
+namespace
+{
+    /**
+     * @brief Обработчик ошибок libjpeg: возврат вместо exit()
+     */
+    struct DecodeError
+    {
+        jpeg_error_mgr manager;
+        jmp_buf jump;
+    };
+
+    void decodeErrorExit(j_common_ptr cinfo)
+    {
+        longjmp(((DecodeError *)cinfo->err)->jump, 1);
+    }
+}
+
+/**
+ * @brief Декодирование JPEG с масштабом 1/2^scale
+ *
+ * Порядок вызовов writer тот же, что у драйвера: размер кадра
+ * (data == nullptr, x = y = 0), блоки MCU слева направо и сверху вниз,
+ * завершение (data == nullptr, x = w, y = h).
+ */
+esp_err_t esp_jpg_decode(size_t len, jpg_scale_t scale, jpg_reader_cb reader, jpg_writer_cb writer, void *arg)
+{
+    std::vector<uint8_t> data(len);
+    for (size_t index = 0; index < len;)
+    {
+        size_t chunk = reader(arg, index, data.data() + index, len - index < JPG_READ_CHUNK ? len - index : JPG_READ_CHUNK);
+        if (!chunk)
+            return ESP_FAIL;
+        index += chunk;
+    }
+
+    jpeg_decompress_struct cinfo;
+    DecodeError error;
+    cinfo.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = decodeErrorExit;
+    if (setjmp(error.jump))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        return ESP_FAIL;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, data.data(), (unsigned long)len);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1u << scale;
+    jpeg_start_decompress(&cinfo);
+
+    const int width = cinfo.output_width;
+    const int height = cinfo.output_height;
+    int mcuWidth = (cinfo.max_h_samp_factor * DCTSIZE) >> scale;
+    int mcuHeight = (cinfo.max_v_samp_factor * DCTSIZE) >> scale;
+    if (mcuWidth < 1)
+        mcuWidth = 1;
+    if (mcuHeight < 1)
+        mcuHeight = 1;
+
+    bool ok = writer(arg, 0, 0, width, height, nullptr);
+    std::vector<uint8_t> rows((size_t)width * 3 * mcuHeight);
+    std::vector<uint8_t> block((size_t)mcuWidth * mcuHeight * 3);
+
+    for (int y = 0; ok && y < height; y += mcuHeight)
+    {
+        const int h = height - y < mcuHeight ? height - y : mcuHeight;
+        for (int r = 0; r < h;)
+        {
+            JSAMPROW row = rows.data() + (size_t)r * width * 3;
+            r += jpeg_read_scanlines(&cinfo, &row, 1);
+        }
+
+        for (int x = 0; ok && x < width; x += mcuWidth)
+        {
+            const int w = width - x < mcuWidth ? width - x : mcuWidth;
+            for (int r = 0; r < h; r++)
+                memcpy(block.data() + (size_t)r * w * 3, rows.data() + ((size_t)r * width + x) * 3, (size_t)w * 3);
+            ok = writer(arg, x, y, w, h, block.data());
+        }
+    }
+
+    if (!ok)
+    {
+        jpeg_abort_decompress(&cinfo);
+        jpeg_destroy_decompress(&cinfo);
+        return ESP_FAIL;
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    writer(arg, width, height, width, height, nullptr);
+    return ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * @file test_main.cpp
+ * @brief Модель фона: передний план, обновление и пересоздание
+ *
+ * Кадр, совпадающий с фоном, не даёт переднего плана; объект даёт ровно
+ * свои пиксели, а при обновлении фон сходится к неподвижному объекту и
+ * тот перестаёт считаться передним планом. Фон вне области не меняется.
+ */
+
+#include "Detection/BackgroundModel.hpp"
+#include "TestCheck.hpp"
+#include <string.h>
+
+#define W 40
+#define H 30
+
+/**
+ * @brief Кадр с яркостью фона и прямоугольником объекта
+ */
+static void fillFrame(uint8_t *image, int background, const PixelRect *object, int objectLuma)
+{
+    memset(image, background, W * H);
+    if (!object)
+        return;
+    for (int y = object->y; y < object->y + object->height; y++)
+        memset(image + y * W + object->x, objectLuma, object->width);
+}
+
+/**
+ * @brief Буфер сохраняется при тех же размерах и пересоздаётся при других
+ */
+static void testInit()
+{
+    BackgroundModel model;
+    CHECK(!backgroundModelInit(model, 0, H));
+    CHECK(backgroundModelInit(model, W, H));
+    CHECK(!model.seeded);
+
+    uint8_t image[W * H];
+    fillFrame(image, 100, nullptr, 0);
+    backgroundModelSeed(model, image);
+    CHECK(model.seeded);
+    CHECK_EQ(model.mean[0], 100 << 8);
+
+    // Те же размеры: засеянная модель остаётся
+    CHECK(backgroundModelInit(model, W, H));
+    CHECK(model.seeded);
+
+    // Другие размеры: модель ждёт нового засева
+    CHECK(backgroundModelInit(model, W / 2, H / 2));
+    CHECK(!model.seeded);
+    CHECK_EQ(model.width, W / 2);
+
+    backgroundModelFree(model);
+    CHECK(model.mean == nullptr);
+    CHECK(!model.seeded);
+}
+
+/**
+ * @brief Передний план: строгое превышение порога в обе стороны
+ */
+static void testForeground()
+{
+    BackgroundModel model;
+    CHECK(backgroundModelInit(model, W, H));
+    uint8_t image[W * H];
+    fillFrame(image, 100, nullptr, 0);
+    backgroundModelSeed(model, image);
+
+    PixelRect all = {0, 0, W, H, 0};
+    CHECK_EQ(backgroundModelProcess(model, image, all, 20, 3, false), 0);
+
+    // Светлый и тёмный объекты; отличие ровно на порог - не передний план
+    PixelRect bright = {2, 2, 5, 4, 0};
+    PixelRect dark = {20, 10, 6, 3, 0};
+    PixelRect edge = {30, 20, 4, 4, 0};
+    fillFrame(image, 100, &bright, 140);
+    for (int y = dark.y; y < dark.y + dark.height; y++)
+        memset(image + y * W + dark.x, 60, dark.width);
+    for (int y = edge.y; y < edge.y + edge.height; y++)
+        memset(image + y * W + edge.x, 120, edge.width);
+
+    CHECK_EQ(backgroundModelProcess(model, image, all, 20, 3, false), 5 * 4 + 6 * 3);
+    CHECK_EQ(backgroundModelProcess(model, image, bright, 20, 3, false), 5 * 4);
+
+    // Маска строки совпадает с подсчётом
+    uint8_t mask[W];
+    backgroundModelMaskRow(model, image, dark.y, 0, W, 20, mask);
+    int masked = 0;
+    for (int x = 0; x < W; x++)
+        masked += mask[x];
+    CHECK_EQ(masked, dark.width);
+    CHECK_EQ(mask[dark.x], 1);
+    CHECK_EQ(mask[dark.x - 1], 0);
+
+    backgroundModelFree(model);
+}
+
+/**
+ * @brief Фон сходится к неподвижному объекту только внутри области
+ */
+static void testUpdate()
+{
+    BackgroundModel model;
+    CHECK(backgroundModelInit(model, W, H));
+    uint8_t image[W * H];
+    fillFrame(image, 100, nullptr, 0);
+    backgroundModelSeed(model, image);
+
+    PixelRect object = {10, 5, 10, 10, 0};
+    PixelRect zone = {0, 0, W / 2 + 5, H, 0};
+    fillFrame(image, 100, &object, 200);
+
+    // Без обновления фон не меняется
+    for (int i = 0; i < 20; i++)
+        backgroundModelProcess(model, image, zone, 20, 3, false);
+    CHECK_EQ(backgroundModelProcess(model, image, zone, 20, 3, false), 100);
+
+    // Отличие убывает как (7/8)^n: первые кадры объект ещё виден
+    for (int i = 0; i < 5; i++)
+        backgroundModelProcess(model, image, zone, 20, 3, true);
+    CHECK_EQ(backgroundModelProcess(model, image, zone, 20, 3, false), 100);
+
+    for (int i = 0; i < 40; i++)
+        backgroundModelProcess(model, image, zone, 20, 3, true);
+    CHECK_EQ(backgroundModelProcess(model, image, zone, 20, 3, false), 0);
+    CHECK((model.mean[object.y * W + object.x] >> 8) > 180);
+
+    // Пиксели вне зоны не обновлялись
+    CHECK_EQ(model.mean[0], 100 << 8);
+    CHECK_EQ(model.mean[(H - 1) * W + W - 1], 100 << 8);
+
+    // Объект ушёл: фон внутри зоны теперь отличается от кадра
+    fillFrame(image, 100, nullptr, 0);
+    CHECK_EQ(backgroundModelProcess(model, image, zone, 20, 3, false), 100);
+
+    backgroundModelFree(model);
+}
+
+int main()
+{
+    testInit();
+    testForeground();
+    testUpdate();
+    return testResult("test_background_model");
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+/**
+ * @file test_main.cpp
+ * @brief Выделение связных областей против заливки
+ *
+ * Площадь наибольшей области и число пикселей маски сверяются с
+ * заливкой по 8-связности на случайных масках разной плотности. Таблица
+ * серий, рассчитанная blobRunCapacity(), не должна переполняться даже на
+ * шахматной маске.
+ */
+
+#include "Detection/BlobLabeler.hpp"
+#include "TestCheck.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+static BlobLabeler labeler;
+
+/**
+ * @brief Площадь наибольшей 8-связной области заливкой
+ */
+static uint32_t referenceLargest(const std::vector<uint8_t> &image, int width, int height, uint32_t &total)
+{
+    std::vector<bool> seen(image.size(), false);
+    std::vector<int> stack;
+    uint32_t best = 0;
+    total = 0;
+
+    for (int i = 0; i < width * height; i++)
+    {
+        if (image[i] >= 128)
+            continue;
+        total++;
+        if (seen[i])
+            continue;
+
+        uint32_t area = 0;
+        seen[i] = true;
+        stack.push_back(i);
+        while (!stack.empty())
+        {
+            int p = stack.back();
+            stack.pop_back();
+            area++;
+            int px = p % width;
+            int py = p / width;
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    int nx = px + dx;
+                    int ny = py + dy;
+                    if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+                        continue;
+                    int q = ny * width + nx;
+                    if (image[q] < 128 && !seen[q])
+                    {
+                        seen[q] = true;
+                        stack.push_back(q);
+                    }
+                }
+            }
+        }
+        if (area > best)
+            best = area;
+    }
+    return best;
+}
+
+/**
+ * @brief Разметка маски целиком
+ */
+static bool label(const std::vector<uint8_t> &image, int width, int height, BlobInfo &blob)
+{
+    blobLabelerReset(labeler);
+    for (int y = 0; y < height; y++)
+        blobAddDarkRow(labeler, &image[y * width], 0, width, y, 128);
+    return blobLargest(labeler, blob);
+}
+
+/**
+ * @brief Случайные маски от почти пустых до почти сплошных
+ */
+static void testRandomMasks()
+{
+    for (int iter = 0; iter < 3000; iter++)
+    {
+        int width = 1 + rand() % 80;
+        int height = 1 + rand() % 60;
+        int density = rand() % 100;
+        std::vector<uint8_t> image(width * height);
+        for (size_t i = 0; i < image.size(); i++)
+            image[i] = (rand() % 100 < density) ? 10 : 200;
+
+        CHECK(blobLabelerInit(labeler, blobRunCapacity(width, height)));
+        BlobInfo blob;
+        bool found = label(image, width, height, blob);
+
+        uint32_t total;
+        uint32_t largest = referenceLargest(image, width, height, total);
+        CHECK(!labeler.overflow);
+        CHECK_EQ(labeler.pixels, total);
+        CHECK_EQ(blob.area, largest);
+        CHECK(found == (largest > 0));
+    }
+}
+
+/**
+ * @brief Шахматная маска зоны 80x60: худший случай числа серий
+ */
+static void testCheckerboard()
+{
+    const int width = 80;
+    const int height = 60;
+    std::vector<uint8_t> image(width * height);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+            image[y * width + x] = ((x + y) & 1) ? 200 : 10;
+    }
+
+    CHECK_EQ(blobRunCapacity(width, height), 2400);
+    CHECK(blobLabelerInit(labeler, blobRunCapacity(width, height)));
+    BlobInfo blob;
+    CHECK(label(image, width, height, blob));
+    CHECK(!labeler.overflow);
+    CHECK_EQ(labeler.runCount, 2400);
+
+    // По диагоналям шахматная маска связна целиком
+    CHECK_EQ(blob.area, 2400);
+}
+
+/**
+ * @brief Рамка и центр масс прямоугольника с шумом в стороне
+ */
+static void testBoundingBox()
+{
+    const int width = 60;
+    const int height = 40;
+    std::vector<uint8_t> image(width * height, 200);
+    for (int y = 10; y < 30; y++)
+    {
+        for (int x = 20; x < 50; x++)
+            image[y * width + x] = 10;
+    }
+    image[2 * width + 2] = 10;
+    image[38 * width + 5] = 10;
+
+    CHECK(blobLabelerInit(labeler, blobRunCapacity(width, height)));
+    BlobInfo blob;
+    CHECK(label(image, width, height, blob));
+    CHECK_EQ(blob.area, 600);
+    CHECK_EQ(blob.minX, 20);
+    CHECK_EQ(blob.maxX, 49);
+    CHECK_EQ(blob.minY, 10);
+    CHECK_EQ(blob.maxY, 29);
+    CHECK(fabs(blob.centroidX - 34.5f) < 1e-3f);
+    CHECK(fabs(blob.centroidY - 19.5f) < 1e-3f);
+    CHECK_EQ(labeler.pixels, 602);
+}
+
+/**
+ * @brief Переполнение малой таблицы отмечается, пиксели считаются все
+ */
+static void testOverflow()
+{
+    const int width = 20;
+    const int height = 4;
+    std::vector<uint8_t> image(width * height);
+    for (int i = 0; i < width * height; i++)
+        image[i] = (i & 1) ? 200 : 10;
+
+    BlobLabeler small;
+    CHECK(blobLabelerInit(small, 8));
+    blobLabelerReset(small);
+    for (int y = 0; y < height; y++)
+        blobAddDarkRow(small, &image[y * width], 0, width, y, 128);
+    CHECK(small.overflow);
+    CHECK_EQ(small.runCount, 8);
+    CHECK_EQ(small.pixels, width * height / 2);
+    blobLabelerFree(small);
+    CHECK_EQ(small.capacity, 0);
+}
+
+int main()
+{
+    srand(9);
+    testRandomMasks();
+    testCheckerboard();
+    testBoundingBox();
+    testOverflow();
+    blobLabelerFree(labeler);
+    return testResult("test_blob_labeler");
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+/**
+ * @file test_main.cpp
+ * @brief Арбитр камеры: совместное владение, ожидание и возврат профиля
+ *
+ * Профиль сенсора имитируется переменной; проверяется, что владельцы
+ * одного профиля разделяют его без переключения, запрос другого профиля
+ * ждёт освобождения камеры всеми владельцами, а после последнего
+ * освобождения возвращается базовый профиль. Ожидающий детектор
+ * не пропускает вперёд запросы снимков и потока, а поток видит, что
+ * должен уступить камеру.
+ */
+
+#include "Camera/CameraArbiter.hpp"
+#include "TestCheck.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Профили имитации: 0 - базовый (детекция), 1 - фото, 2 - поток
+enum
+{
+    TEST_PROFILE_BASE,
+    TEST_PROFILE_PHOTO,
+    TEST_PROFILE_STREAM
+};
+
+static std::atomic<int> sensorProfile(-1);
+static std::atomic<int> applies(0);
+
+static bool applyProfile(void *, int profile)
+{
+    sensorProfile = profile;
+    applies++;
+    return true;
+}
+
+static bool failApply(void *, int profile)
+{
+    return profile == TEST_PROFILE_BASE;
+}
+
+static void testCoalesceAndWait()
+{
+    CameraArbiter arbiter;
+    cameraArbiterInit(arbiter, TEST_PROFILE_BASE, applyProfile, nullptr);
+    sensorProfile = TEST_PROFILE_BASE;
+    applies = 0;
+
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_STREAM, TEST_PROFILE_STREAM, 100, nullptr));
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_STREAM);
+
+    // Снимок в том же профиле присоединяется без переключения
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_SNAPSHOT, TEST_PROFILE_STREAM, 100, nullptr));
+    CHECK_EQ(applies.load(), 1);
+    CHECK_EQ(arbiter.stats[OWNER_SNAPSHOT].coalesced, 1u);
+
+    // Другой профиль не дожидается занятой камеры
+    CHECK(!cameraArbiterAcquire(arbiter, OWNER_DETECTOR, TEST_PROFILE_PHOTO, 50, nullptr));
+    CHECK_EQ(arbiter.stats[OWNER_DETECTOR].timeouts, 1u);
+
+    // ... и получает её после освобождения всеми владельцами
+    std::atomic<bool> acquired(false);
+    std::atomic<int> profileWhileHeld(-1);
+    std::thread detector([&] {
+        acquired = cameraArbiterAcquire(arbiter, OWNER_DETECTOR, TEST_PROFILE_PHOTO, 1000, nullptr);
+        profileWhileHeld = sensorProfile.load();
+        if (acquired)
+            cameraArbiterRelease(arbiter, OWNER_DETECTOR);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    cameraArbiterRelease(arbiter, OWNER_SNAPSHOT);
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_STREAM);
+    cameraArbiterRelease(arbiter, OWNER_STREAM);
+    detector.join();
+
+    CHECK(acquired);
+    CHECK_EQ(profileWhileHeld.load(), (int)TEST_PROFILE_PHOTO);
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_BASE);
+    CHECK_EQ(arbiter.holders, 0);
+    CHECK(arbiter.stats[OWNER_DETECTOR].waitMax >= 20);
+    CHECK_EQ(arbiter.stats[OWNER_DETECTOR].switches, 1u);
+
+    // Лишнее освобождение не портит счётчики
+    cameraArbiterRelease(arbiter, OWNER_STREAM);
+    CHECK_EQ(arbiter.holders, 0);
+}
+
+static void testBaseProfile()
+{
+    CameraArbiter arbiter;
+    cameraArbiterInit(arbiter, TEST_PROFILE_BASE, applyProfile, nullptr);
+    sensorProfile = TEST_PROFILE_BASE;
+
+    // Запрос базового профиля не считается переключением
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_DETECTOR, TEST_PROFILE_BASE, 100, nullptr));
+    CHECK_EQ(arbiter.stats[OWNER_DETECTOR].switches, 0u);
+
+    // Смена базы при занятой камере применяется при освобождении
+    cameraArbiterSetBase(arbiter, TEST_PROFILE_PHOTO);
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_BASE);
+    cameraArbiterRelease(arbiter, OWNER_DETECTOR);
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_PHOTO);
+
+    cameraArbiterSetBase(arbiter, TEST_PROFILE_BASE);
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_BASE);
+}
+
+static void testApplyFailure()
+{
+    CameraArbiter arbiter;
+    cameraArbiterInit(arbiter, TEST_PROFILE_BASE, failApply, nullptr);
+
+    CHECK(!cameraArbiterAcquire(arbiter, OWNER_STREAM, TEST_PROFILE_STREAM, 100, nullptr));
+    CHECK_EQ(arbiter.holders, 0);
+    CHECK_EQ(arbiter.active, -1);
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_DETECTOR, TEST_PROFILE_BASE, 100, nullptr));
+    cameraArbiterRelease(arbiter, OWNER_DETECTOR);
+}
+
+static void testSwitchedFlag()
+{
+    CameraArbiter arbiter;
+    cameraArbiterInit(arbiter, TEST_PROFILE_BASE, applyProfile, nullptr);
+    sensorProfile = TEST_PROFILE_BASE;
+
+    // Смена профиля требует ожидания экспозиции, присоединение и базовый - нет
+    bool switched = false;
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_STREAM, TEST_PROFILE_STREAM, 100, &switched));
+    CHECK(switched);
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_SNAPSHOT, TEST_PROFILE_STREAM, 100, &switched));
+    CHECK(!switched);
+    cameraArbiterRelease(arbiter, OWNER_SNAPSHOT);
+    cameraArbiterRelease(arbiter, OWNER_STREAM);
+
+    switched = true;
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_DETECTOR, TEST_PROFILE_BASE, 100, &switched));
+    CHECK(!switched);
+    cameraArbiterRelease(arbiter, OWNER_DETECTOR);
+
+    // Отказ тоже сбрасывает признак
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_STREAM, TEST_PROFILE_STREAM, 100, nullptr));
+    switched = true;
+    CHECK(!cameraArbiterAcquire(arbiter, OWNER_SNAPSHOT, TEST_PROFILE_PHOTO, 20, &switched));
+    CHECK(!switched);
+    cameraArbiterRelease(arbiter, OWNER_STREAM);
+}
+
+static void testDetectorPriority()
+{
+    CameraArbiter arbiter;
+    cameraArbiterInit(arbiter, TEST_PROFILE_BASE, applyProfile, nullptr);
+    sensorProfile = TEST_PROFILE_BASE;
+
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_STREAM, TEST_PROFILE_STREAM, 100, nullptr));
+    CHECK(!cameraArbiterPreempted(arbiter, OWNER_STREAM));
+
+    // Детектор ждёт камеру в другом профиле
+    std::atomic<bool> detectorAcquired(false);
+    std::atomic<int> profileWhileHeld(-1);
+    std::thread detector([&] {
+        detectorAcquired = cameraArbiterAcquire(arbiter, OWNER_DETECTOR, TEST_PROFILE_PHOTO, 2000, nullptr);
+        profileWhileHeld = sensorProfile.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        if (detectorAcquired)
+            cameraArbiterRelease(arbiter, OWNER_DETECTOR);
+    });
+    while (!cameraArbiterPreempted(arbiter, OWNER_STREAM))
+        std::this_thread::yield();
+
+    // Снимок в профиле потока больше не присоединяется, пока детектор ждёт
+    CHECK(!cameraArbiterAcquire(arbiter, OWNER_SNAPSHOT, TEST_PROFILE_STREAM, 30, nullptr));
+    CHECK_EQ(arbiter.stats[OWNER_SNAPSHOT].timeouts, 1u);
+
+    // Поток уступает камеру и сразу запрашивает её снова: детектор успевает первым
+    cameraArbiterRelease(arbiter, OWNER_STREAM);
+    CHECK(cameraArbiterAcquire(arbiter, OWNER_STREAM, TEST_PROFILE_STREAM, 2000, nullptr));
+    CHECK_EQ(arbiter.stats[OWNER_DETECTOR].requests, 1u);
+    CHECK_EQ(sensorProfile.load(), (int)TEST_PROFILE_STREAM);
+    detector.join();
+
+    CHECK(detectorAcquired);
+    CHECK_EQ(profileWhileHeld.load(), (int)TEST_PROFILE_PHOTO);
+    CHECK(!cameraArbiterPreempted(arbiter, OWNER_STREAM));
+    CHECK(!cameraArbiterPreempted(arbiter, OWNER_DETECTOR));
+    cameraArbiterRelease(arbiter, OWNER_STREAM);
+    CHECK_EQ(arbiter.holders, 0);
+}
+
+int main()
+{
+    testCoalesceAndWait();
+    testBaseProfile();
+    testApplyFailure();
+    testSwitchedFlag();
+    testDetectorPriority();
+    return testResult("camera_arbiter");
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+ * @file test_main.cpp
+ * @brief Установление экспозиции по последовательности яркостей кадров
+ *
+ * Последовательности повторяют переходы после смены профиля: плавный
+ * подход к новой яркости, шум в пределах допуска, выброс от вспышки и
+ * непрочитанные кадры. Возвращается номер кадра, на котором экспозиция
+ * признана установившейся, или -1.
+ */
+
+#include "Camera/ExposureSettle.hpp"
+#include "TestCheck.hpp"
+
+/**
+ * @brief Номер кадра, на котором экспозиция установилась, -1 - не установилась
+ */
+static int settleFrame(const int *brightness, int count, int tolerance)
+{
+    ExposureSettle settle;
+    for (int i = 0; i < count; i++)
+    {
+        if (exposureSettleUpdate(settle, brightness[i], tolerance))
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Нужно два изменения подряд в пределах допуска, то есть три кадра
+ */
+static void testSteady()
+{
+    const int steady[] = {120, 120, 120, 120};
+    CHECK_EQ(settleFrame(steady, 4, 2), 2);
+
+    const int noisy[] = {118, 120, 119, 121};
+    CHECK_EQ(settleFrame(noisy, 4, 2), 2);
+
+    // Изменение ровно на допуск ещё стабильно, на допуск плюс один - нет
+    const int edge[] = {100, 102, 104, 107, 109, 111};
+    CHECK_EQ(settleFrame(edge, 6, 2), 2);
+    const int over[] = {100, 103, 106, 109, 112};
+    CHECK_EQ(settleFrame(over, 5, 2), -1);
+
+    // Допуск 0 требует неизменной яркости
+    const int exact[] = {90, 91, 91, 91};
+    CHECK_EQ(settleFrame(exact, 4, 0), 3);
+}
+
+/**
+ * @brief Автоэкспозиция подходит к новой яркости, выброс начинает отсчёт заново
+ */
+static void testTransition()
+{
+    const int ramp[] = {40, 70, 95, 110, 117, 119, 120, 120};
+    CHECK_EQ(settleFrame(ramp, 8, 2), 6);
+
+    const int glare[] = {120, 121, 200, 121, 120, 120};
+    CHECK_EQ(settleFrame(glare, 6, 2), 5);
+}
+
+/**
+ * @brief Непрочитанные кадры пропускаются и не сбрасывают отсчёт
+ */
+static void testUnreadFrames()
+{
+    const int unread[] = {-1, 120, -1, 121, -1, 120};
+    CHECK_EQ(settleFrame(unread, 6, 2), 5);
+
+    const int none[] = {-1, -1, -1, -1};
+    CHECK_EQ(settleFrame(none, 4, 2), -1);
+
+    // Сброс перед новым ожиданием: прошлая яркость не учитывается
+    ExposureSettle settle;
+    CHECK(!exposureSettleUpdate(settle, 80, 2));
+    CHECK(!exposureSettleUpdate(settle, 80, 2));
+    exposureSettleReset(settle);
+    CHECK(!exposureSettleUpdate(settle, 80, 2));
+    CHECK(!exposureSettleUpdate(settle, 80, 2));
+    CHECK(exposureSettleUpdate(settle, 80, 2));
+}
+
+int main()
+{
+    testSteady();
+    testTransition();
+    testUnreadFrames();
+    return testResult("test_exposure_settle");
+}
\ No newline at end of file
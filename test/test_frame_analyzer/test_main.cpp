@@ -0,0 +1,145 @@
+/**
+ * @file test_main.cpp
+ * @brief Анализ кадра по зонам на синтетической последовательности
+ *
+ * Кадры подаются в detectInFrame() так же, как их подаёт detectCar() на
+ * устройстве: прибытие после confirm_n голосов, отсутствие голоса без
+ * показания датчика расстояния, пропуск статичных кадров фильтром и
+ * независимость текстуры от шага прореживания.
+ */
+
+#include "Detection/FrameAnalyzer.hpp"
+#include "TestCheck.hpp"
+#include <vector>
+
+Settings settings;
+
+static const int FRAME_WIDTH = 160;
+static const int FRAME_HEIGHT = 120;
+
+/**
+ * @brief Светлый кадр, при car - с тёмной текстурированной левой половиной ROI
+ *
+ * При ramp тёмная область - линейный градиент, его энергия на пару соседей
+ * не зависит от шага прореживания.
+ */
+static std::vector<uint8_t> makeFrame(bool car, bool ramp = false)
+{
+    std::vector<uint8_t> frame(FRAME_WIDTH * FRAME_HEIGHT, 200);
+    if (car)
+    {
+        for (int y = 30; y < 90; y++)
+            for (int x = 40; x < 80; x++)
+                frame[y * FRAME_WIDTH + x] = ramp ? 20 + (x - 40) + (y - 30) / 2 : ((x + y) % 3 ? 20 : 60);
+    }
+    return frame;
+}
+
+static void resetSettings()
+{
+    settings = Settings();
+    settings.zone_count = 1;
+    settings.zones[0].x = settings.roi_x;
+    settings.zones[0].y = settings.roi_y;
+    settings.zones[0].width = settings.roi_width;
+    settings.zones[0].height = settings.roi_height;
+    settings.zones[0].threshold = settings.threshold;
+    settings.zones[0].area = settings.area;
+    resetZones();
+}
+
+static uint32_t feed(const std::vector<uint8_t> &frame, int distance, bool &analyzed)
+{
+    return detectInFrame(frame.data(), FRAME_WIDTH, FRAME_HEIGHT, distance, analyzed);
+}
+
+static void testArrivalAndDeparture()
+{
+    resetSettings();
+    std::vector<uint8_t> empty = makeFrame(false);
+    std::vector<uint8_t> car = makeFrame(true);
+    bool analyzed = false;
+
+    CHECK_EQ(feed(empty, 100, analyzed), 0u);
+    CHECK(analyzed);
+    CHECK_EQ(feed(car, 100, analyzed), 0u);
+    CHECK(zoneStates[0].vote);
+    CHECK(!zoneStates[0].occupied);
+    CHECK_EQ(feed(car, 100, analyzed), 1u);
+    CHECK(zoneStates[0].occupied);
+    CHECK(zonesOccupied());
+
+    feed(empty, 100, analyzed);
+    CHECK(zoneStates[0].occupied);
+    feed(empty, 100, analyzed);
+    CHECK(!zoneStates[0].occupied);
+    CHECK(!zonesOccupied());
+}
+
+static void testNoDistanceNoVote()
+{
+    resetSettings();
+    std::vector<uint8_t> car = makeFrame(true);
+    bool analyzed = false;
+
+    for (int i = 0; i < 4; i++)
+        CHECK_EQ(feed(car, 0, analyzed), 0u);
+    CHECK(!zoneStates[0].vote);
+    CHECK(!zoneStates[0].occupied);
+
+    // Дальше порога settings.distance - тоже не голос
+    CHECK_EQ(feed(car, settings.distance + 1, analyzed), 0u);
+    CHECK(!zoneStates[0].vote);
+}
+
+static void testMotionGate()
+{
+    resetSettings();
+    settings.motion_gate = 8;
+    std::vector<uint8_t> empty = makeFrame(false);
+    std::vector<uint8_t> car = makeFrame(true);
+    bool analyzed = false;
+
+    feed(empty, 100, analyzed);
+    CHECK(analyzed);
+    feed(empty, 100, analyzed);
+    CHECK(!analyzed);
+    feed(car, 100, analyzed);
+    CHECK(analyzed);
+    CHECK(zoneStates[0].vote);
+
+    // Пока зона голосует, кадры анализируются и без изменений
+    CHECK_EQ(feed(car, 100, analyzed), 1u);
+    CHECK(analyzed);
+}
+
+static void testTextureStride()
+{
+    std::vector<uint8_t> car = makeFrame(true, true);
+    float texture[3];
+    const int strides[3] = {1, 2, 4};
+    for (int i = 0; i < 3; i++)
+    {
+        resetSettings();
+        settings.texture = 1;
+        settings.stride = strides[i];
+        // Только градиент, без перепада на границе тёмной области
+        settings.zones[0].width = 40;
+        bool analyzed = false;
+        feed(car, 100, analyzed);
+        texture[i] = zoneStates[0].texture;
+    }
+
+    CHECK(texture[0] > 0);
+    for (int i = 1; i < 3; i++)
+        CHECK(texture[i] > texture[0] * 0.8f && texture[i] < texture[0] * 1.25f);
+}
+
+int main()
+{
+    testArrivalAndDeparture();
+    testNoDistanceNoVote();
+    testMotionGate();
+    testTextureStride();
+    return testResult("frame_analyzer");
+}
\ No newline at end of file
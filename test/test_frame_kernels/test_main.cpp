@@ -0,0 +1,105 @@
+/**
+ * @file test_main.cpp
+ * @brief Подсчёт тёмных пикселей: словное ядро против побайтового цикла
+ *
+ * Словное ядро обязано давать те же числа, что и простой цикл, при любом
+ * выравнивании строки, длине хвоста и пороге, включая 0 и 256.
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include "TestCheck.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @brief Эталонный подсчёт: один пиксель за итерацию
+ */
+static uint32_t referenceDarkCount(const uint8_t *image, int stride, int x, int y, int width, int height,
+                                   int threshold)
+{
+    uint32_t count = 0;
+    for (int row = y; row < y + height; row++)
+    {
+        for (int col = x; col < x + width; col++)
+        {
+            if (image[row * stride + col] < threshold)
+                count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Все значения байта при всех порогах в каждой позиции слова
+ */
+static void testRowAllValues()
+{
+    uint8_t row[16];
+    for (int threshold = 0; threshold <= 256; threshold++)
+    {
+        for (int value = 0; value < 256; value++)
+        {
+            for (int pos = 0; pos < 8; pos++)
+            {
+                memset(row, 255, sizeof(row));
+                row[pos] = (uint8_t)value;
+                uint32_t expected = (value < threshold ? 1 : 0) + (threshold > 255 ? 7 : 0);
+                CHECK_EQ(countDarkPixelsRow(row, 8, threshold), expected);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Случайные строки со всеми сдвигами начала и длинами хвоста
+ */
+static void testRowAlignment()
+{
+    uint8_t buf[64 + 8];
+    srand(1);
+    for (int iter = 0; iter < 2000; iter++)
+    {
+        for (size_t i = 0; i < sizeof(buf); i++)
+            buf[i] = (uint8_t)rand();
+        int threshold = rand() % 258;
+        for (int offset = 0; offset < 8; offset++)
+        {
+            int length = rand() % 65;
+            CHECK_EQ(countDarkPixelsRow(buf + offset, length, threshold),
+                     referenceDarkCount(buf + offset, 0, 0, 0, length, 1, threshold));
+        }
+    }
+}
+
+/**
+ * @brief Произвольные области кадра QQVGA, в том числе пустые и на краях
+ */
+static void testRegions()
+{
+    const int width = DETECTION_FRAME_WIDTH;
+    const int height = DETECTION_FRAME_HEIGHT;
+    std::vector<uint8_t> frame(width * height + 8);
+    srand(2);
+    for (int iter = 0; iter < 5000; iter++)
+    {
+        for (size_t i = 0; i < frame.size(); i++)
+            frame[i] = (uint8_t)rand();
+        const uint8_t *image = frame.data() + (iter & 7);
+        int x = rand() % width;
+        int y = rand() % height;
+        int w = rand() % (width - x + 1);
+        int h = rand() % (height - y + 1);
+        int threshold = rand() % 300 - 20;
+        CHECK_EQ(countDarkPixels(image, width, x, y, w, h, threshold),
+                 referenceDarkCount(image, width, x, y, w, h, threshold));
+    }
+}
+
+int main()
+{
+    testRowAllValues();
+    testRowAlignment();
+    testRegions();
+    return testResult("test_frame_kernels");
+}
\ No newline at end of file
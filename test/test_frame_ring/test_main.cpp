@@ -0,0 +1,131 @@
+/**
+ * @file test_main.cpp
+ * @brief Кольцо кадров: порядок слотов, ссылки читателей и гонки
+ *
+ * Однопоточные проверки выбора слота и подсчёта ссылок, затем писатель
+ * и два читателя в отдельных потоках: читатель никогда не видит слот,
+ * который перезаписывается, и номера кадров у него только растут.
+ */
+
+#include "Camera/FrameRing.hpp"
+#include "TestCheck.hpp"
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+// Размер кадра в тесте
+#define TEST_FRAME_BYTES 64
+
+static void writeFrame(FrameRing &ring, uint32_t value)
+{
+    FrameSlot *slot = frameRingBeginWrite(ring);
+    CHECK(slot != nullptr);
+    if (!slot)
+        return;
+    memset(slot->buf, value & 0xFF, TEST_FRAME_BYTES);
+    frameRingCommit(ring, slot, TEST_FRAME_BYTES, 8, 8, value);
+}
+
+static void testLatestAndRefs()
+{
+    FrameRing ring;
+    CHECK(frameRingInit(ring, TEST_FRAME_BYTES));
+    CHECK(frameRingAcquireLatest(ring, 0) == nullptr);
+
+    writeFrame(ring, 1);
+    writeFrame(ring, 2);
+    const FrameSlot *latest = frameRingAcquireLatest(ring, 0);
+    CHECK(latest != nullptr);
+    CHECK_EQ(latest->sequence, 2u);
+    CHECK(frameRingAcquireLatest(ring, latest->sequence) == nullptr);
+
+    // Слот с читателем не перезаписывается: остальные два уходят под запись
+    FrameSlot *first = frameRingBeginWrite(ring);
+    FrameSlot *second = frameRingBeginWrite(ring);
+    CHECK(first != latest && second != latest && first != second);
+    CHECK(frameRingBeginWrite(ring) == nullptr);
+    CHECK_EQ(ring.framesDropped, 1u);
+
+    // Пишущиеся слоты читателям не видны
+    const FrameSlot *again = frameRingAcquireLatest(ring, 0);
+    CHECK(again == latest);
+    frameRingRelease(ring, again);
+
+    frameRingAbort(ring, first);
+    CHECK_EQ(frameRingCommit(ring, second, TEST_FRAME_BYTES, 8, 8, 3), 3u);
+    frameRingRelease(ring, latest);
+
+    const FrameSlot *newest = frameRingAcquireLatest(ring, 2);
+    CHECK(newest == second);
+    CHECK_EQ(newest->sequence, 3u);
+    frameRingRelease(ring, newest);
+
+    frameRingFree(ring);
+}
+
+static void testConcurrentReaders()
+{
+    static FrameRing ring;
+    CHECK(frameRingInit(ring, TEST_FRAME_BYTES));
+    std::atomic<bool> stop(false);
+    std::atomic<long> torn(0);
+    std::atomic<long> reordered(0);
+
+    std::thread writer([&] {
+        uint32_t value = 0;
+        while (!stop)
+        {
+            FrameSlot *slot = frameRingBeginWrite(ring);
+            if (!slot)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            value++;
+            memset(slot->buf, value & 0xFF, TEST_FRAME_BYTES);
+            frameRingCommit(ring, slot, TEST_FRAME_BYTES, 8, 8, value);
+        }
+    });
+
+    auto reader = [&] {
+        uint32_t last = 0;
+        for (int i = 0; i < 100000; i++)
+        {
+            const FrameSlot *slot = frameRingAcquireLatest(ring, last);
+            if (!slot)
+                continue;
+            // Байты кадра и отметка времени записаны одним writeFrame
+            const uint8_t value = slot->buf[0];
+            for (int k = 0; k < TEST_FRAME_BYTES; k++)
+                if (slot->buf[k] != value)
+                    torn++;
+            if ((slot->timestamp & 0xFF) != value)
+                torn++;
+            if (slot->sequence <= last)
+                reordered++;
+            last = slot->sequence;
+            frameRingRelease(ring, slot);
+        }
+    };
+
+    std::thread first(reader);
+    std::thread second(reader);
+    first.join();
+    second.join();
+    stop = true;
+    writer.join();
+
+    CHECK_EQ(torn.load(), 0);
+    CHECK_EQ(reordered.load(), 0);
+    CHECK(ring.framesWritten > 0);
+    for (int i = 0; i < FRAME_RING_SLOTS; i++)
+        CHECK_EQ(ring.slots[i].refs, 0);
+    frameRingFree(ring);
+}
+
+int main()
+{
+    testLatestAndRefs();
+    testConcurrentReaders();
+    return testResult("frame_ring");
+}
\ No newline at end of file
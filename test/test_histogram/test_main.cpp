@@ -0,0 +1,138 @@
+/**
+ * @file test_main.cpp
+ * @brief Гистограмма зоны и надёжность порога Оцу
+ *
+ * На двухмодальной зоне (автомобиль на асфальте) порог Оцу должен лежать
+ * между модами и считаться надёжным; на однородной пустой площадке
+ * разбиение находится всегда, но надёжным считаться не должно.
+ */
+
+#include "Detection/Histogram.hpp"
+#include "TestCheck.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Приближённо нормальное значение: сумма четырёх равномерных
+ */
+static int noisy(int mean, int spread)
+{
+    int sum = 0;
+    for (int i = 0; i < 4; i++)
+        sum += rand() % (2 * spread + 1) - spread;
+    int value = mean + sum / 2;
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+/**
+ * @brief Гистограмма из count значений вокруг mean
+ */
+static void addMode(uint32_t *bins, int count, int mean, int spread)
+{
+    for (int i = 0; i < count; i++)
+        bins[noisy(mean, spread)]++;
+}
+
+/**
+ * @brief Автомобиль на асфальте: две разделённые моды
+ */
+static void testBimodal()
+{
+    uint32_t bins[HISTOGRAM_BINS] = {0};
+    addMode(bins, 1900, 35, 10);
+    addMode(bins, 2900, 150, 12);
+
+    HistogramStats stats;
+    histogramStats(bins, stats);
+    CHECK(stats.otsuReliable);
+    CHECK(stats.otsuThreshold > 35 && stats.otsuThreshold < 150);
+    CHECK(stats.otsuSeparation > 100);
+    CHECK_EQ(histogramCountBelow(bins, stats.otsuThreshold), 1900);
+}
+
+/**
+ * @brief Однородная пустая площадка при разном шуме
+ */
+static void testUniformBay()
+{
+    for (int spread = 0; spread <= 24; spread += 4)
+    {
+        uint32_t bins[HISTOGRAM_BINS] = {0};
+        addMode(bins, 4800, 140, spread);
+
+        HistogramStats stats;
+        histogramStats(bins, stats);
+        CHECK(!stats.otsuReliable);
+    }
+}
+
+/**
+ * @brief Плавный перепад освещённости: равномерная гистограмма
+ */
+static void testGradientBay()
+{
+    uint32_t bins[HISTOGRAM_BINS] = {0};
+    for (int i = 60; i < 200; i++)
+        bins[i] = 40;
+
+    HistogramStats stats;
+    histogramStats(bins, stats);
+    CHECK(stats.otsuSeparation > OTSU_MIN_SEPARATION);
+    CHECK(fabs(stats.otsuEffectiveness - 0.75f) < 0.01f);
+    CHECK(!stats.otsuReliable);
+}
+
+/**
+ * @brief Пустая гистограмма и перцентили
+ */
+static void testStats()
+{
+    uint32_t bins[HISTOGRAM_BINS] = {0};
+    HistogramStats stats;
+    histogramStats(bins, stats);
+    CHECK_EQ(stats.totalPixels, 0);
+    CHECK(!stats.otsuReliable);
+
+    for (int i = 0; i < 100; i++)
+        bins[i] = 1;
+    histogramStats(bins, stats);
+    CHECK_EQ(stats.totalPixels, 100);
+    CHECK(fabs(stats.mean - 49.5f) < 1e-3f);
+    CHECK_EQ(stats.p10, 9);
+    CHECK_EQ(stats.p50, 49);
+    CHECK_EQ(stats.p90, 89);
+}
+
+/**
+ * @brief Гистограмма области кадра
+ */
+static void testBuild()
+{
+    uint8_t image[20 * 10];
+    for (int i = 0; i < 200; i++)
+        image[i] = (uint8_t)(i % 7);
+
+    PixelRect region = {3, 2, 5, 4, 0};
+    uint32_t bins[HISTOGRAM_BINS];
+    buildHistogram(image, 20, region, bins);
+
+    uint32_t expected[HISTOGRAM_BINS] = {0};
+    for (int y = 2; y < 6; y++)
+    {
+        for (int x = 3; x < 8; x++)
+            expected[image[y * 20 + x]]++;
+    }
+    CHECK(memcmp(bins, expected, sizeof(bins)) == 0);
+}
+
+int main()
+{
+    srand(11);
+    testBimodal();
+    testUniformBay();
+    testGradientBay();
+    testStats();
+    testBuild();
+    return testResult("test_histogram");
+}
\ No newline at end of file
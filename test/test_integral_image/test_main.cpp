@@ -0,0 +1,95 @@
+/**
+ * @file test_main.cpp
+ * @brief Интегральное изображение против полного перебора области
+ *
+ * Число тёмных пикселей, сумма яркости и статистика области по четырём
+ * обращениям к таблице сверяются с прямым обходом, в том числе для
+ * областей, выходящих за край кадра, и для кадров разного размера.
+ */
+
+#include "Detection/IntegralImage.hpp"
+#include "TestCheck.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+/**
+ * @brief Прямой обход области с отсечением по краям кадра
+ */
+static void referenceStats(const std::vector<uint8_t> &image, int frameWidth, int frameHeight, int x, int y,
+                           int width, int height, int threshold, uint32_t &total, uint32_t &dark,
+                           uint32_t &luma)
+{
+    total = dark = luma = 0;
+    for (int row = y; row < y + height; row++)
+    {
+        for (int col = x; col < x + width; col++)
+        {
+            if (col < 0 || row < 0 || col >= frameWidth || row >= frameHeight)
+                continue;
+            uint8_t value = image[row * frameWidth + col];
+            total++;
+            dark += value < threshold;
+            luma += value;
+        }
+    }
+}
+
+/**
+ * @brief Случайные кадры и области для одной геометрии
+ */
+static void testFrame(int frameWidth, int frameHeight, bool withLuma)
+{
+    IntegralImage ii;
+    std::vector<uint8_t> image(frameWidth * frameHeight);
+
+    for (int frame = 0; frame < 50; frame++)
+    {
+        for (size_t i = 0; i < image.size(); i++)
+            image[i] = (uint8_t)rand();
+        int threshold = rand() % 257;
+
+        CHECK(integralImageInit(ii, frameWidth, frameHeight, withLuma));
+        integralImageBuild(ii, image.data(), threshold);
+        CHECK_EQ(ii.threshold, threshold);
+        CHECK(withLuma == (ii.luma != nullptr));
+
+        for (int query = 0; query < 200; query++)
+        {
+            int x = rand() % (frameWidth + 10) - 5;
+            int y = rand() % (frameHeight + 10) - 5;
+            int width = rand() % (frameWidth + 10);
+            int height = rand() % (frameHeight + 10);
+
+            uint32_t total, dark, luma;
+            referenceStats(image, frameWidth, frameHeight, x, y, width, height, threshold, total, dark, luma);
+
+            RegionStats stats;
+            bool valid = integralImageStats(ii, x, y, width, height, stats);
+            CHECK_EQ(stats.totalPixels, total);
+            CHECK_EQ(stats.darkPixels, dark);
+            if (valid && total > 0)
+                CHECK(fabs(stats.darkRatio - (float)dark / total) < 1e-6);
+
+            if (withLuma)
+            {
+                CHECK_EQ(integralImageLumaSum(ii, x, y, width, height), luma);
+                if (valid && total > 0)
+                    CHECK(fabs(stats.meanLuma - (float)luma / total) < 1e-3);
+            }
+        }
+    }
+
+    integralImageFree(ii);
+    CHECK(ii.mask == nullptr && ii.luma == nullptr);
+}
+
+int main()
+{
+    srand(3);
+    testFrame(160, 120, false);
+    testFrame(160, 120, true);
+    testFrame(320, 240, true);
+    testFrame(37, 11, true);
+    return testResult("test_integral_image");
+}
\ No newline at end of file
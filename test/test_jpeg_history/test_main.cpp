@@ -0,0 +1,189 @@
+/**
+ * @file test_main.cpp
+ * @brief История JPEG: вытеснение, перенос в начало области и заморозка
+ *
+ * Однопоточные проверки лимита кадров, бюджета байт и переноса записи в
+ * начало области, затем писатель в отдельном потоке: пока история
+ * заморожена на время сохранения, её кадры не меняются и не вытесняются.
+ */
+
+#include "Camera/JpegHistory.hpp"
+#include "TestCheck.hpp"
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Кадр: все байты равны младшему байту номера
+ */
+static bool push(JpegHistory &history, uint32_t sequence, size_t len)
+{
+    std::vector<uint8_t> data(len, (uint8_t)sequence);
+    return jpegHistoryPush(history, data.data(), len, sequence * 100, sequence);
+}
+
+/**
+ * @brief Кадр index истории цел и имеет ожидаемый номер
+ */
+static bool frameIntact(const JpegHistory &history, int index, uint32_t sequence)
+{
+    JpegHistoryEntry entry;
+    const uint8_t *data = jpegHistoryFrame(history, index, entry);
+    if (!data || entry.sequence != sequence || entry.timestamp != sequence * 100)
+        return false;
+    for (size_t i = 0; i < entry.len; i++)
+    {
+        if (data[i] != (uint8_t)sequence)
+            return false;
+    }
+    return entry.offset + entry.len <= history.capacity;
+}
+
+/**
+ * @brief Лимит кадров и ограничения init
+ */
+static void testLimit()
+{
+    static uint8_t arena[1000];
+    JpegHistory history;
+    CHECK(!jpegHistoryInit(history, nullptr, sizeof(arena), 4));
+    CHECK(!jpegHistoryInit(history, arena, sizeof(arena), 0));
+    CHECK(jpegHistoryInit(history, arena, sizeof(arena), JPEG_HISTORY_MAX_FRAMES + 5));
+    CHECK_EQ(history.limit, JPEG_HISTORY_MAX_FRAMES);
+
+    CHECK(jpegHistoryInit(history, arena, sizeof(arena), 3));
+    for (uint32_t s = 1; s <= 5; s++)
+        CHECK(push(history, s, 10));
+    CHECK_EQ(history.count, 3);
+    CHECK_EQ(history.evicted, 2);
+    CHECK(frameIntact(history, 0, 3));
+    CHECK(frameIntact(history, 2, 5));
+    CHECK_EQ(jpegHistoryUsed(history), 30);
+
+    JpegHistoryEntry entry;
+    CHECK(jpegHistoryFrame(history, 3, entry) == nullptr);
+    CHECK(jpegHistoryFrame(history, -1, entry) == nullptr);
+}
+
+/**
+ * @brief Бюджет байт: перенос в начало вытесняет только пересечённые кадры
+ */
+static void testWrap()
+{
+    static uint8_t arena[100];
+    JpegHistory history;
+    CHECK(jpegHistoryInit(history, arena, sizeof(arena), 8));
+
+    CHECK(push(history, 1, 40));
+    CHECK(push(history, 2, 40));
+    // Третий не помещается до конца области: пишется с начала на месте первого
+    CHECK(push(history, 3, 40));
+    CHECK_EQ(history.count, 2);
+    CHECK(frameIntact(history, 0, 2));
+    CHECK(frameIntact(history, 1, 3));
+
+    // Четвёртый пересекает второй (40..80)
+    CHECK(push(history, 4, 30));
+    CHECK_EQ(history.count, 2);
+    CHECK(frameIntact(history, 0, 3));
+    CHECK(frameIntact(history, 1, 4));
+
+    // Кадр больше бюджета отклоняется, история не меняется
+    CHECK(!push(history, 5, 101));
+    CHECK_EQ(history.rejected, 1);
+    CHECK_EQ(history.count, 2);
+
+    // Кадр во всю область вытесняет всё
+    CHECK(push(history, 6, 100));
+    CHECK_EQ(history.count, 1);
+    CHECK(frameIntact(history, 0, 6));
+
+    // Кадры разной длины: занятое место не превышает бюджет
+    for (uint32_t s = 7; s < 200; s++)
+    {
+        CHECK(push(history, s, 5 + s * 7 % 45));
+        CHECK(jpegHistoryUsed(history) <= sizeof(arena));
+        CHECK(frameIntact(history, history.count - 1, s));
+        CHECK(frameIntact(history, 0, s - history.count + 1));
+    }
+}
+
+/**
+ * @brief Заморозка: кадры не принимаются, снятие заморозки возвращает приём
+ */
+static void testFreeze()
+{
+    static uint8_t arena[200];
+    JpegHistory history;
+    CHECK(jpegHistoryInit(history, arena, sizeof(arena), 4));
+    for (uint32_t s = 1; s <= 3; s++)
+        push(history, s, 50);
+
+    CHECK_EQ(jpegHistoryFreeze(history), 3);
+    CHECK(!push(history, 4, 50));
+    CHECK_EQ(history.rejected, 1);
+    CHECK_EQ(history.count, 3);
+    CHECK(frameIntact(history, 0, 1));
+
+    jpegHistoryThaw(history);
+    CHECK(push(history, 4, 50));
+    CHECK(push(history, 5, 50));
+    CHECK_EQ(history.count, 4);
+    CHECK(frameIntact(history, 0, 2));
+
+    // Повторная инициализация снимает заморозку
+    jpegHistoryFreeze(history);
+    CHECK(jpegHistoryInit(history, arena, sizeof(arena), 4));
+    CHECK(push(history, 6, 50));
+}
+
+/**
+ * @brief Писатель в отдельном потоке и сохранение с заморозкой
+ */
+static void testConcurrentFreeze()
+{
+    static uint8_t arena[4096];
+    JpegHistory history;
+    CHECK(jpegHistoryInit(history, arena, sizeof(arena), 12));
+
+    std::atomic<bool> done(false);
+    std::thread writer([&] {
+        for (uint32_t s = 1; !done; s++)
+            push(history, s, 100 + s * 37 % 700);
+    });
+
+    int saves = 0;
+    while (saves < 2000)
+    {
+        int count = jpegHistoryFreeze(history);
+        JpegHistoryEntry first;
+        bool ok = count == 0 || jpegHistoryFrame(history, 0, first) != nullptr;
+        for (int i = 0; ok && i < count; i++)
+        {
+            ok = frameIntact(history, i, first.sequence + i);
+            // Писатель не успевает испортить кадр, пока история заморожена
+            std::this_thread::yield();
+            ok = ok && frameIntact(history, i, first.sequence + i);
+        }
+        CHECK(ok);
+        CHECK_EQ(history.count, count);
+        jpegHistoryThaw(history);
+        saves++;
+        std::this_thread::yield();
+    }
+
+    done = true;
+    writer.join();
+    CHECK(history.pushed > 0);
+    CHECK(history.rejected > 0);
+}
+
+int main()
+{
+    testLimit();
+    testWrap();
+    testFreeze();
+    testConcurrentFreeze();
+    return testResult("test_jpeg_history");
+}
\ No newline at end of file
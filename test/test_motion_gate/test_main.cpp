@@ -0,0 +1,118 @@
+/**
+ * @file test_main.cpp
+ * @brief Фильтр неизменившихся кадров и его счётчики
+ *
+ * Каждый кадр попадает ровно в один из счётчиков framesAnalyzed и
+ * framesGated. Сравнение идёт с последним проанализированным кадром,
+ * поэтому медленный дрейф в итоге пропускается на анализ.
+ */
+
+#include "Detection/MotionGate.hpp"
+#include "TestCheck.hpp"
+#include <string.h>
+
+#define W 160
+#define H 120
+
+/**
+ * @brief Проверка кадра с контролем суммы счётчиков
+ */
+static bool check(MotionGate &gate, const uint8_t *image, int sensitivity, uint32_t &frames)
+{
+    bool analyzed = motionGateCheck(gate, image, W, H, sensitivity);
+    frames++;
+    CHECK_EQ(gate.framesAnalyzed + gate.framesGated, frames);
+    return analyzed;
+}
+
+/**
+ * @brief Неизменный кадр, изменение ниже и выше чувствительности
+ */
+static void testGate()
+{
+    static uint8_t image[W * H];
+    memset(image, 90, sizeof(image));
+    MotionGate gate;
+    uint32_t frames = 0;
+
+    CHECK(check(gate, image, 8, frames));
+    CHECK(!check(gate, image, 8, frames));
+    CHECK(!check(gate, image, 8, frames));
+    CHECK_EQ(gate.framesAnalyzed, 1);
+    CHECK_EQ(gate.framesGated, 2);
+
+    // Изменение одной ячейки (центр 2x2 в точке 35,45) ровно на порог
+    // не пропускается, на порог плюс один - пропускается
+    for (int y = 45; y < 47; y++)
+        memset(image + y * W + 35, 98, 2);
+    CHECK(!check(gate, image, 8, frames));
+    for (int y = 45; y < 47; y++)
+        memset(image + y * W + 35, 99, 2);
+    CHECK(check(gate, image, 8, frames));
+    CHECK(!check(gate, image, 8, frames));
+
+    // Изменение между центрами ячеек сигнатура не видит
+    memset(image + 50 * W, 255, 10);
+    CHECK(!check(gate, image, 8, frames));
+
+    CHECK_EQ(gate.framesAnalyzed, 2);
+    CHECK_EQ(gate.framesGated, 5);
+}
+
+/**
+ * @brief Дрейф освещения накапливается относительно опорного кадра
+ */
+static void testDrift()
+{
+    static uint8_t image[W * H];
+    MotionGate gate;
+    uint32_t frames = 0;
+
+    int analyzed = 0;
+    for (int luma = 100; luma <= 130; luma += 2)
+    {
+        memset(image, luma, sizeof(image));
+        analyzed += check(gate, image, 8, frames);
+    }
+
+    // Опорный кадр: 100, 110, 120, 130 (шаг 2 > 8 на каждом пятом кадре)
+    CHECK_EQ(analyzed, 4);
+    CHECK_EQ(gate.framesAnalyzed, 4);
+    CHECK_EQ(gate.framesGated, frames - 4);
+}
+
+/**
+ * @brief Выключенный фильтр, малый кадр и сброс опорного кадра
+ */
+static void testBypass()
+{
+    static uint8_t image[W * H];
+    memset(image, 50, sizeof(image));
+    MotionGate gate;
+    uint32_t frames = 0;
+
+    CHECK(check(gate, image, 0, frames));
+    CHECK(check(gate, image, 0, frames));
+    CHECK(!gate.hasReference);
+
+    CHECK(motionGateCheck(gate, image, 2 * MOTION_SIGNATURE_COLS - 1, H, 8));
+    CHECK(motionGateCheck(gate, image, 2 * MOTION_SIGNATURE_COLS - 1, H, 8));
+    frames += 2;
+    CHECK_EQ(gate.framesAnalyzed, 4);
+    CHECK_EQ(gate.framesGated, 0);
+
+    CHECK(check(gate, image, 8, frames));
+    CHECK(!check(gate, image, 8, frames));
+    motionGateReset(gate);
+    CHECK(check(gate, image, 8, frames));
+    CHECK_EQ(gate.framesAnalyzed, 6);
+    CHECK_EQ(gate.framesGated, 1);
+}
+
+int main()
+{
+    testGate();
+    testDrift();
+    testBypass();
+    return testResult("test_motion_gate");
+}
\ No newline at end of file
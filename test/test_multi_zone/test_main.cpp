@@ -0,0 +1,88 @@
+/**
+ * @file test_main.cpp
+ * @brief Оценка нескольких зон за один проход по кадру
+ *
+ * countDarkPixelsRegions() должна давать для каждой зоны то же число,
+ * что и отдельный подсчёт по зоне, при перекрывающихся, соприкасающихся
+ * и пустых зонах и при своём пороге у каждой зоны.
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include "TestCheck.hpp"
+#include <stdlib.h>
+#include <vector>
+
+// Зон в кадре, как MAX_DETECTION_ZONES в Config.hpp
+#define ZONE_COUNT 4
+
+/**
+ * @brief Случайная зона внутри кадра; каждая десятая - пустая
+ */
+static PixelRect randomZone(int width, int height)
+{
+    PixelRect r;
+    r.x = rand() % width;
+    r.y = rand() % height;
+    r.width = (rand() % 10 == 0) ? 0 : rand() % (width - r.x + 1);
+    r.height = rand() % (height - r.y + 1);
+    r.threshold = rand() % 257;
+    return r;
+}
+
+/**
+ * @brief Случайные зоны на случайных кадрах
+ */
+static void testRandomZones(int width, int height)
+{
+    std::vector<uint8_t> image(width * height);
+    for (int iter = 0; iter < 500; iter++)
+    {
+        for (size_t i = 0; i < image.size(); i++)
+            image[i] = (uint8_t)rand();
+
+        int zoneCount = 1 + rand() % ZONE_COUNT;
+        PixelRect zones[ZONE_COUNT];
+        uint32_t counts[ZONE_COUNT];
+        for (int i = 0; i < zoneCount; i++)
+            zones[i] = randomZone(width, height);
+
+        countDarkPixelsRegions(image.data(), width, zones, zoneCount, counts);
+        for (int i = 0; i < zoneCount; i++)
+        {
+            CHECK_EQ(counts[i], countDarkPixels(image.data(), width, zones[i].x, zones[i].y, zones[i].width,
+                                                zones[i].height, zones[i].threshold));
+        }
+    }
+}
+
+/**
+ * @brief Три соседних парковочных места: тёмный автомобиль только во втором
+ */
+static void testAdjacentBays()
+{
+    const int width = DETECTION_FRAME_WIDTH;
+    const int height = DETECTION_FRAME_HEIGHT;
+    std::vector<uint8_t> image(width * height, 180);
+    for (int y = 40; y < 90; y++)
+    {
+        for (int x = 60; x < 100; x++)
+            image[y * width + x] = 30;
+    }
+
+    PixelRect zones[3] = {{0, 30, 53, 70, 100}, {53, 30, 54, 70, 100}, {107, 30, 53, 70, 100}};
+    uint32_t counts[3];
+    countDarkPixelsRegions(image.data(), width, zones, 3, counts);
+    CHECK_EQ(counts[0], 0);
+    CHECK_EQ(counts[1], 40 * 50);
+    CHECK_EQ(counts[2], 0);
+}
+
+int main()
+{
+    srand(7);
+    testRandomZones(DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT);
+    testRandomZones(320, 240);
+    testRandomZones(53, 17);
+    testAdjacentBays();
+    return testResult("test_multi_zone");
+}
\ No newline at end of file
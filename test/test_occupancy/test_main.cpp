@@ -0,0 +1,69 @@
+/**
+ * @file test_main.cpp
+ * @brief Автомат занятости зоны на заданных последовательностях голосов
+ *
+ * Сценарий - строка голосов кадров ('1' - автомобиль виден, '0' - нет),
+ * ожидаемые состояния после каждого кадра (E, A, O, L) и события
+ * ('+' - прибытие, '-' - отъезд, '.' - нет события).
+ */
+
+#include "Detection/OccupancyTracker.hpp"
+#include "TestCheck.hpp"
+#include <string.h>
+
+/**
+ * @brief Буква состояния для сравнения со сценарием
+ */
+static char stateLetter(OccupancyState state)
+{
+    return occupancyStateName(state)[0];
+}
+
+/**
+ * @brief Прогон сценария с голосованием n из m
+ */
+static void runScript(int n, int m, const char *votes, const char *states, const char *events)
+{
+    CHECK_EQ(strlen(states), strlen(votes));
+    CHECK_EQ(strlen(events), strlen(votes));
+
+    OccupancyTracker tracker;
+    for (size_t i = 0; votes[i] && states[i] && events[i]; i++)
+    {
+        OccupancyEvent event = occupancyUpdate(tracker, votes[i] == '1', n, m);
+        char eventLetter = event == OCCUPANCY_ARRIVED ? '+' : (event == OCCUPANCY_DEPARTED ? '-' : '.');
+        if (stateLetter(tracker.state) != states[i] || eventLetter != events[i])
+        {
+            printf("%d/%d \"%s\" frame %zu: state %c event %c, expected %c %c\n", n, m, votes, i,
+                   stateLetter(tracker.state), eventLetter, states[i], events[i]);
+            testFailures++;
+            return;
+        }
+        CHECK(occupancyIsOccupied(tracker) == (states[i] == 'O' || states[i] == 'L'));
+    }
+}
+
+int main()
+{
+    // Прибытие по 2 из 3 несмотря на пропуск, отъезд по двум подряд
+    runScript(2, 3, "0101001100", "EAAOLEAOLE", "...+.-.+.-");
+    // Одиночный шумный кадр не вызывает съёмки
+    runScript(2, 3, "0100000", "EAAEEEE", ".......");
+    // Одиночный пропуск у стоящего автомобиля не освобождает зону
+    runScript(2, 3, "1101101", "AOLLOLL", ".+.....");
+    // 1 из 1: прежнее поведение, решение по каждому кадру
+    runScript(1, 1, "1011", "OEOO", "+-+.");
+    // 3 из 5: окно отъезда истекает без трёх пропусков, зона остаётся занятой
+    runScript(3, 5, "110101111", "AAAOLLLLO", "...+.....");
+    // Недопустимые n и m ограничиваются: n > m превращается в m из m
+    runScript(4, 2, "1101", "AOLO", ".+..");
+
+    OccupancyTracker tracker;
+    occupancyUpdate(tracker, true, 1, 1);
+    CHECK(occupancyIsOccupied(tracker));
+    occupancyReset(tracker);
+    CHECK_EQ(tracker.state, ZONE_EMPTY);
+    CHECK(!occupancyIsOccupied(tracker));
+
+    return testResult("test_occupancy");
+}
\ No newline at end of file
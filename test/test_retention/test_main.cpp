@@ -0,0 +1,107 @@
+/**
+ * @file test_main.cpp
+ * @brief Ограничение архива по диапазону номеров фотографий
+ *
+ * Проверяются границы диапазона и цикл удаления как в retentionEnforce():
+ * по числу фотографий, по свободному месту, которое растёт с каждым
+ * удалением, и сохранение последней фотографии при заполненной карте.
+ */
+
+#include "Storage/RetentionRange.hpp"
+#include "TestCheck.hpp"
+
+/**
+ * @brief Число удалений до выхода в пределы ограничений
+ *
+ * Каждое удаление освобождает freedPerPhoto процентов карты.
+ */
+static uint32_t evictions(uint32_t &oldest, uint32_t newest, int maxFiles, int minFreePercent,
+                          int freePercent, int freedPerPhoto)
+{
+    uint32_t evicted = 0;
+    while (retentionOverCount(oldest, newest, maxFiles) ||
+           (retentionMayFreeSpace(oldest, newest, minFreePercent) && freePercent < minFreePercent))
+    {
+        oldest++;
+        evicted++;
+        freePercent += freedPerPhoto;
+    }
+    return evicted;
+}
+
+static void testRangeCount()
+{
+    CHECK_EQ(retentionRangeCount(1, 1), 1u);
+    CHECK_EQ(retentionRangeCount(5, 14), 10u);
+    // Все фотографии удалены: oldest опережает последний номер
+    CHECK_EQ(retentionRangeCount(15, 14), 0u);
+    CHECK_EQ(retentionRangeCount(1, 0xFFFFFFFEu), 0xFFFFFFFEu);
+}
+
+static void testMaxFiles()
+{
+    // Ровно max_files - в пределах, на одну больше - удаление
+    CHECK(!retentionOverCount(1, 10, 10));
+    CHECK(retentionOverCount(1, 11, 10));
+    CHECK(!retentionOverCount(2, 11, 10));
+    // Без ограничения и для пустого архива удалять нечего
+    CHECK(!retentionOverCount(1, 100000, 0));
+    CHECK(!retentionOverCount(1, 100000, -1));
+    CHECK(!retentionOverCount(20, 10, 1));
+
+    uint32_t oldest = 1;
+    CHECK_EQ(evictions(oldest, 250, 100, 0, 0, 0), 150u);
+    CHECK_EQ(oldest, 151u);
+    CHECK_EQ(retentionRangeCount(oldest, 250), 100u);
+
+    // Пропуски в номерах считаются занятыми: диапазон не сжимается
+    oldest = 40;
+    CHECK_EQ(evictions(oldest, 60, 5, 0, 0, 0), 16u);
+    CHECK_EQ(oldest, 56u);
+}
+
+static void testFreeSpace()
+{
+    CHECK(!retentionMayFreeSpace(1, 10, 0));
+    CHECK(retentionMayFreeSpace(1, 10, 5));
+    CHECK(retentionMayFreeSpace(9, 10, 5));
+    // Последняя фотография не удаляется ради места
+    CHECK(!retentionMayFreeSpace(10, 10, 5));
+    CHECK(!retentionMayFreeSpace(11, 10, 5));
+
+    // 2% свободно, нужно 10%, каждое удаление освобождает 3%
+    uint32_t oldest = 1;
+    CHECK_EQ(evictions(oldest, 50, 0, 10, 2, 3), 3u);
+    CHECK_EQ(oldest, 4u);
+
+    // Места не хватает и без архива: остаётся последняя фотография
+    oldest = 1;
+    CHECK_EQ(evictions(oldest, 50, 0, 10, 0, 0), 49u);
+    CHECK_EQ(oldest, 50u);
+
+    // Достаточно места - удалять нечего
+    oldest = 1;
+    CHECK_EQ(evictions(oldest, 50, 0, 10, 10, 1), 0u);
+}
+
+static void testBothLimits()
+{
+    // max_files удаляет до 30 фотографий, затем место добирается дальше
+    uint32_t oldest = 1;
+    CHECK_EQ(evictions(oldest, 40, 30, 20, 0, 1), 20u);
+    CHECK_EQ(oldest, 21u);
+
+    // max_files = 1 удаляет и последнюю лишнюю, хотя место не требуется
+    oldest = 1;
+    CHECK_EQ(evictions(oldest, 3, 1, 10, 50, 0), 2u);
+    CHECK_EQ(oldest, 3u);
+}
+
+int main()
+{
+    testRangeCount();
+    testMaxFiles();
+    testFreeSpace();
+    testBothLimits();
+    return testResult("test_retention");
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+/**
+ * @file test_main.cpp
+ * @brief Профили сенсора на имитации сенсора: пропуск лишних записей
+ *
+ * Имитация хранит значения полей и считает записи. Проверяется, что
+ * повторное применение профиля не обращается к сенсору, переключение
+ * записывает только отличающиеся поля, а неудачная запись повторяется
+ * при следующем применении.
+ */
+
+#include "Camera/SensorProfile.hpp"
+#include "TestCheck.hpp"
+
+/**
+ * @brief Имитация сенсора
+ */
+struct MockSensor
+{
+    int values[SENSOR_FIELD_COUNT] = {0};
+    int writes = 0;
+    bool failFramesize = false;
+};
+
+static bool mockWrite(void *context, SensorField field, int value)
+{
+    MockSensor *sensor = (MockSensor *)context;
+    if (sensor->failFramesize && field == SENSOR_FRAMESIZE)
+        return false;
+    sensor->values[field] = value;
+    sensor->writes++;
+    return true;
+}
+
+// Порядок полей: framesize, pixformat, quality, brightness, gainceiling, aec2
+static const SensorProfile detection = {"detection", {1, 2, SENSOR_KEEP, 0, 0, 0}};
+static const SensorProfile photo = {"photo", {9, 4, 10, 0, 0, 0}};
+static const SensorProfile night = {"night", {1, 2, SENSOR_KEEP, 1, 6, 1}};
+
+enum
+{
+    ID_DETECTION,
+    ID_PHOTO,
+    ID_NIGHT = 3
+};
+
+static void checkSensor(const MockSensor &sensor, const SensorProfile &profile)
+{
+    for (int i = 0; i < SENSOR_FIELD_COUNT; i++)
+        if (profile.values[i] != SENSOR_KEEP)
+            CHECK_EQ(sensor.values[i], profile.values[i]);
+}
+
+int main()
+{
+    MockSensor sensor;
+    SensorCache cache;
+
+    // Состояние после setupCamera(): известны размер, формат и качество
+    const int initial[][2] = {{SENSOR_FRAMESIZE, 9}, {SENSOR_PIXFORMAT, 4}, {SENSOR_QUALITY, 10}};
+    for (const auto &field : initial)
+    {
+        sensor.values[field[0]] = field[1];
+        sensorCacheSeed(cache, (SensorField)field[0], field[1]);
+    }
+
+    // Первое применение: неизвестные поля пишутся, quality не трогается
+    CHECK_EQ(sensorProfileApply(cache, detection, ID_DETECTION, mockWrite, &sensor), 5);
+    checkSensor(sensor, detection);
+    CHECK_EQ(cache.profile, (int)ID_DETECTION);
+
+    // Повтор того же профиля пропускается целиком
+    int writes = sensor.writes;
+    CHECK_EQ(sensorProfileApply(cache, detection, ID_DETECTION, mockWrite, &sensor), 0);
+    CHECK_EQ(sensor.writes, writes);
+    CHECK_EQ(cache.skipped, 1u);
+
+    // Переключения пишут только отличающиеся поля
+    CHECK_EQ(sensorProfileApply(cache, photo, ID_PHOTO, mockWrite, &sensor), 2);
+    checkSensor(sensor, photo);
+    CHECK_EQ(sensorProfileApply(cache, detection, ID_DETECTION, mockWrite, &sensor), 2);
+    checkSensor(sensor, detection);
+    CHECK_EQ(sensorProfileApply(cache, night, ID_NIGHT, mockWrite, &sensor), 3);
+    checkSensor(sensor, night);
+
+    // Неудачная запись: профиль неизвестен, повтор дописывает только её
+    sensor.failFramesize = true;
+    sensorProfileApply(cache, photo, ID_PHOTO, mockWrite, &sensor);
+    CHECK_EQ(cache.profile, -1);
+    sensor.failFramesize = false;
+    CHECK_EQ(sensorProfileApply(cache, photo, ID_PHOTO, mockWrite, &sensor), 1);
+    CHECK_EQ(cache.profile, (int)ID_PHOTO);
+    checkSensor(sensor, photo);
+
+    // Кэш сходится со счётчиком имитации
+    CHECK_EQ(cache.writes, (uint32_t)sensor.writes);
+    CHECK(cache.elided > 0);
+
+    // После сброса кэша профиль записывается полностью
+    sensorCacheInvalidate(cache);
+    CHECK_EQ(sensorProfileApply(cache, photo, ID_PHOTO, mockWrite, &sensor), 6);
+
+    return testResult("sensor_profile");
+}
\ No newline at end of file
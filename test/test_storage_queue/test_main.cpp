@@ -0,0 +1,167 @@
+/**
+ * @file test_main.cpp
+ * @brief Очередь записи: порядок, вытеснение старых и ожидание места
+ *
+ * Однопоточные проверки обоих режимов заполненной очереди, затем
+ * детекция и задача записи в отдельных потоках: каждое событие либо
+ * записано, либо отброшено ровно один раз, и порядок записи сохраняется.
+ */
+
+#include "Storage/StorageQueue.hpp"
+#include "TestCheck.hpp"
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Указатель-метка для номера события
+ */
+static void *tag(uintptr_t value)
+{
+    return (void *)value;
+}
+
+static void testOrderAndDropOldest()
+{
+    StorageQueue queue;
+    storageQueueInit(queue, 3);
+    void *dropped = tag(99);
+
+    for (uintptr_t i = 1; i <= 3; i++)
+    {
+        CHECK(storageQueuePush(queue, tag(i), STORAGE_DROP_OLDEST, 0, dropped));
+        CHECK(dropped == nullptr);
+    }
+
+    // Заполненная очередь отдаёт самое старое событие
+    CHECK(storageQueuePush(queue, tag(4), STORAGE_DROP_OLDEST, 0, dropped));
+    CHECK(dropped == tag(1));
+    CHECK_EQ(storageQueueCount(queue), 3);
+    CHECK_EQ(queue.depthMax, 3);
+
+    void *item = nullptr;
+    for (uintptr_t i = 2; i <= 4; i++)
+    {
+        CHECK(storageQueuePop(queue, item, 0));
+        CHECK(item == tag(i));
+    }
+    CHECK(!storageQueuePop(queue, item, 10));
+    CHECK_EQ(storageQueueCount(queue), 0);
+}
+
+static void testBlock()
+{
+    StorageQueue queue;
+    storageQueueInit(queue, 2);
+    void *dropped = nullptr;
+    CHECK(storageQueuePush(queue, tag(1), STORAGE_BLOCK, 0, dropped));
+    CHECK(storageQueuePush(queue, tag(2), STORAGE_BLOCK, 0, dropped));
+
+    // Без задачи записи ожидание заканчивается отказом, очередь не меняется
+    auto start = std::chrono::steady_clock::now();
+    CHECK(!storageQueuePush(queue, tag(3), STORAGE_BLOCK, 40, dropped));
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    CHECK(waited.count() >= 35);
+    CHECK(dropped == nullptr);
+    CHECK_EQ(storageQueueCount(queue), 2);
+
+    // Задача записи освобождает место во время ожидания
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        void *item = nullptr;
+        CHECK(storageQueuePop(queue, item, 0));
+        CHECK(item == tag(1));
+    });
+    CHECK(storageQueuePush(queue, tag(3), STORAGE_BLOCK, 2000, dropped));
+    writer.join();
+    CHECK(dropped == nullptr);
+
+    void *item = nullptr;
+    CHECK(storageQueuePop(queue, item, 0) && item == tag(2));
+    CHECK(storageQueuePop(queue, item, 0) && item == tag(3));
+}
+
+static void testLimits()
+{
+    StorageQueue queue;
+    void *dropped = nullptr;
+    storageQueueInit(queue, 0);
+    CHECK(!storageQueuePush(queue, tag(1), STORAGE_DROP_OLDEST, 0, dropped));
+    CHECK(!storageQueuePush(queue, tag(1), STORAGE_BLOCK, 10, dropped));
+
+    storageQueueInit(queue, STORAGE_QUEUE_MAX + 10);
+    CHECK_EQ(queue.capacity, STORAGE_QUEUE_MAX);
+
+    // Задача записи ждёт событие, пока оно не поставлено
+    std::atomic<bool> received(false);
+    std::thread writer([&] {
+        void *item = nullptr;
+        received = storageQueuePop(queue, item, 2000) && item == tag(7);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(storageQueuePush(queue, tag(7), STORAGE_DROP_OLDEST, 0, dropped));
+    writer.join();
+    CHECK(received);
+}
+
+/**
+ * @brief Быстрая детекция и медленная запись при обоих режимах
+ */
+static void testProducerConsumer(StoragePolicy policy)
+{
+    const uintptr_t events = 3000;
+    StorageQueue queue;
+    storageQueueInit(queue, 4);
+
+    std::vector<uintptr_t> written;
+    std::thread writer([&] {
+        void *item = nullptr;
+        while (storageQueuePop(queue, item, 200))
+        {
+            written.push_back((uintptr_t)item);
+            if (written.size() % 64 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    uintptr_t dropped = 0;
+    uintptr_t rejected = 0;
+    for (uintptr_t i = 1; i <= events; i++)
+    {
+        void *oldest = nullptr;
+        if (!storageQueuePush(queue, tag(i), policy, 50, oldest))
+            rejected++;
+        if (oldest)
+            dropped++;
+    }
+    writer.join();
+
+    CHECK_EQ(written.size() + dropped + rejected, events);
+    CHECK(queue.depthMax <= 4);
+    bool ordered = true;
+    for (size_t i = 1; i < written.size(); i++)
+        ordered = ordered && written[i] > written[i - 1];
+    CHECK(ordered);
+    if (policy == STORAGE_BLOCK)
+    {
+        CHECK_EQ(dropped, 0);
+        CHECK_EQ(rejected, 0);
+    }
+    else
+    {
+        CHECK_EQ(rejected, 0);
+        CHECK(written.back() == events);
+    }
+}
+
+int main()
+{
+    testOrderAndDropOldest();
+    testBlock();
+    testLimits();
+    testProducerConsumer(STORAGE_DROP_OLDEST);
+    testProducerConsumer(STORAGE_BLOCK);
+    return testResult("test_storage_queue");
+}
\ No newline at end of file
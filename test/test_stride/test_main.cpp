@@ -0,0 +1,138 @@
+/**
+ * @file test_main.cpp
+ * @brief Прореживание кадра для анализа с шагом 2 и 4
+ *
+ * Проверяет, что прореженный кадр берёт каждый step-й пиксель, что доля
+ * тёмных пикселей зоны почти не меняется с шагом и что текстура,
+ * нормированная на пару соседей и на квадрат шага, на плавном перепаде
+ * яркости от шага не зависит.
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include "TestCheck.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+static const int width = DETECTION_FRAME_WIDTH;
+static const int height = DETECTION_FRAME_HEIGHT;
+
+/**
+ * @brief Зона 40,30 80x60 в координатах прореженного кадра
+ */
+static PixelRect decimatedZone(int step)
+{
+    PixelRect r;
+    r.x = (40 + step - 1) / step;
+    r.y = (30 + step - 1) / step;
+    r.width = (120 + step - 1) / step - r.x;
+    r.height = (90 + step - 1) / step - r.y;
+    r.threshold = 128;
+    return r;
+}
+
+/**
+ * @brief Пиксель прореженного кадра берётся из (x * step, y * step)
+ */
+static void testDecimate()
+{
+    std::vector<uint8_t> image(width * height);
+    for (size_t i = 0; i < image.size(); i++)
+        image[i] = (uint8_t)rand();
+
+    for (int step = 2; step <= 4; step += 2)
+    {
+        const int outWidth = (width + step - 1) / step;
+        const int outHeight = (height + step - 1) / step;
+        std::vector<uint8_t> out(outWidth * outHeight, 0);
+        PixelRect area = decimatedZone(step);
+        decimateFrame(image.data(), width, step, area, out.data(), outWidth);
+
+        for (int y = 0; y < outHeight; y++)
+        {
+            for (int x = 0; x < outWidth; x++)
+            {
+                bool inside = x >= area.x && x < area.x + area.width && y >= area.y && y < area.y + area.height;
+                int expected = inside ? image[y * step * width + x * step] : 0;
+                CHECK_EQ(out[y * outWidth + x], expected);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Доля тёмных пикселей зоны на кадрах с тёмным прямоугольником
+ */
+static void testDarkRatio()
+{
+    std::vector<uint8_t> image(width * height);
+    std::vector<uint8_t> out(width * height);
+    for (int step = 2; step <= 4; step += 2)
+    {
+        const int outWidth = (width + step - 1) / step;
+        PixelRect zone = decimatedZone(step);
+        double worst = 0;
+        for (int iter = 0; iter < 200; iter++)
+        {
+            int cx = rand() % width;
+            int cy = rand() % height;
+            int halfWidth = 5 + rand() % 30;
+            int halfHeight = 5 + rand() % 20;
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    bool car = abs(x - cx) < halfWidth && abs(y - cy) < halfHeight;
+                    image[y * width + x] = (uint8_t)(car ? 40 + rand() % 40 : 150 + rand() % 40);
+                }
+            }
+
+            double full = countDarkPixels(image.data(), width, 40, 30, 80, 60, 128) / 4800.0;
+            decimateFrame(image.data(), width, step, zone, out.data(), outWidth);
+            double sampled = countDarkPixels(out.data(), outWidth, zone.x, zone.y, zone.width, zone.height, 128) /
+                             (double)(zone.width * zone.height);
+            worst = fmax(worst, fabs(sampled - full));
+        }
+        CHECK(worst < 0.06);
+    }
+}
+
+/**
+ * @brief Текстура плавного перепада яркости не зависит от шага
+ */
+static void testTextureNormalised()
+{
+    std::vector<uint8_t> image(width * height);
+    std::vector<uint8_t> out(width * height);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+            image[y * width + x] = (uint8_t)((x + y) > 255 ? 255 : x + y);
+    }
+
+    uint32_t count;
+    float reference;
+    PixelRect zone = decimatedZone(1);
+    analyzeRegionsTexture(image.data(), width, &zone, 1, &count, &reference, nullptr);
+    CHECK(fabs(reference - 1.0f) < 1e-6f);
+
+    for (int step = 2; step <= 4; step += 2)
+    {
+        const int outWidth = (width + step - 1) / step;
+        zone = decimatedZone(step);
+        decimateFrame(image.data(), width, step, zone, out.data(), outWidth);
+
+        float texture;
+        analyzeRegionsTexture(out.data(), outWidth, &zone, 1, &count, &texture, nullptr);
+        CHECK(fabs(texture / (step * step) - reference) < 1e-6f);
+    }
+}
+
+int main()
+{
+    srand(4);
+    testDecimate();
+    testDarkRatio();
+    testTextureNormalised();
+    return testResult("test_stride");
+}
\ No newline at end of file
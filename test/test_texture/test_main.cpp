@@ -0,0 +1,149 @@
+/**
+ * @file test_main.cpp
+ * @brief Тёмные пиксели и текстура зон за один проход
+ *
+ * analyzeRegionsTexture() сверяется с раздельным подсчётом: число тёмных
+ * пикселей - с countDarkPixels(), текстура - со средним квадратом разности
+ * соседей на пару соседних пикселей зоны, гистограмма, построенная в том
+ * же проходе, - с buildHistogram().
+ */
+
+#include "Detection/FrameKernels.hpp"
+#include "Detection/Histogram.hpp"
+#include "TestCheck.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * @brief Эталонная текстура: средний квадрат разности на пару соседей зоны
+ */
+static double referenceTexture(const std::vector<uint8_t> &image, int width, const PixelRect &r)
+{
+    double energy = 0;
+    int pairs = 0;
+    for (int y = r.y; y < r.y + r.height; y++)
+    {
+        for (int x = r.x; x < r.x + r.width; x++)
+        {
+            int p = image[y * width + x];
+            if (x + 1 < r.x + r.width)
+            {
+                int dx = image[y * width + x + 1] - p;
+                energy += dx * dx;
+                pairs++;
+            }
+            if (y + 1 < r.y + r.height)
+            {
+                int dy = image[(y + 1) * width + x] - p;
+                energy += dy * dy;
+                pairs++;
+            }
+        }
+    }
+    return pairs > 0 ? energy / pairs : 0;
+}
+
+/**
+ * @brief Случайные зоны на шумовых кадрах
+ */
+static void testRandomZones(int width, int height)
+{
+    std::vector<uint8_t> image(width * height);
+    for (int iter = 0; iter < 500; iter++)
+    {
+        for (size_t i = 0; i < image.size(); i++)
+            image[i] = (uint8_t)rand();
+
+        PixelRect zones[3];
+        for (int k = 0; k < 3; k++)
+        {
+            zones[k].x = rand() % width;
+            zones[k].y = rand() % height;
+            zones[k].width = rand() % (width - zones[k].x + 1);
+            zones[k].height = rand() % (height - zones[k].y + 1);
+            zones[k].threshold = rand() % 257;
+        }
+
+        uint32_t counts[3];
+        float textures[3];
+        analyzeRegionsTexture(image.data(), width, zones, 3, counts, textures, nullptr);
+        for (int k = 0; k < 3; k++)
+        {
+            const PixelRect &r = zones[k];
+            CHECK_EQ(counts[k], countDarkPixels(image.data(), width, r.x, r.y, r.width, r.height, r.threshold));
+            double expected = referenceTexture(image, width, r);
+            CHECK(fabs(textures[k] - expected) <= 1e-4 * expected + 1e-3);
+        }
+    }
+}
+
+/**
+ * @brief Гистограммы автоматических зон в проходе текстуры
+ */
+static void testHistogramInTexturePass()
+{
+    const int width = DETECTION_FRAME_WIDTH;
+    const int height = DETECTION_FRAME_HEIGHT;
+    std::vector<uint8_t> image(width * height);
+    static uint32_t bins[2][HISTOGRAM_BINS];
+    uint32_t expected[HISTOGRAM_BINS];
+
+    for (int iter = 0; iter < 200; iter++)
+    {
+        for (size_t i = 0; i < image.size(); i++)
+            image[i] = (uint8_t)rand();
+
+        PixelRect zones[3] = {{0, 0, 50, 40, 0}, {50, 20, 60, 70, 120}, {100, 60, 60, 60, 0}};
+        uint32_t *histograms[3] = {bins[0], nullptr, bins[1]};
+        uint32_t counts[3];
+        float textures[3];
+        float plain[3];
+        analyzeRegionsTexture(image.data(), width, zones, 3, counts, textures, histograms);
+        analyzeRegionsTexture(image.data(), width, zones, 3, counts, plain, nullptr);
+
+        for (int k = 0; k < 3; k++)
+            CHECK(textures[k] == plain[k]);
+
+        buildHistogram(image.data(), width, zones[0], expected);
+        CHECK(memcmp(bins[0], expected, sizeof(expected)) == 0);
+        buildHistogram(image.data(), width, zones[2], expected);
+        CHECK(memcmp(bins[1], expected, sizeof(expected)) == 0);
+        CHECK_EQ(counts[1], countDarkPixels(image.data(), width, 50, 20, 60, 70, 120));
+    }
+}
+
+/**
+ * @brief Ровное тёмное пятно без текстуры и полосатая решётка радиатора
+ */
+static void testFlatVersusTextured()
+{
+    const int width = DETECTION_FRAME_WIDTH;
+    const int height = DETECTION_FRAME_HEIGHT;
+    std::vector<uint8_t> image(width * height, 40);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = width / 2; x < width; x++)
+            image[y * width + x] = (y & 1) ? 20 : 60;
+    }
+
+    PixelRect zones[2] = {{0, 0, width / 2, height, 100}, {width / 2, 0, width / 2, height, 100}};
+    uint32_t counts[2];
+    float textures[2];
+    analyzeRegionsTexture(image.data(), width, zones, 2, counts, textures, nullptr);
+    CHECK_EQ(counts[0], (width / 2) * height);
+    CHECK_EQ(counts[1], (width / 2) * height);
+    CHECK(textures[0] == 0);
+    CHECK(textures[1] > 700 && textures[1] < 1600);
+}
+
+int main()
+{
+    srand(5);
+    testRandomZones(DETECTION_FRAME_WIDTH, DETECTION_FRAME_HEIGHT);
+    testRandomZones(61, 23);
+    testHistogramInTexturePass();
+    testFlatVersusTextured();
+    return testResult("test_texture");
+}
\ No newline at end of file